@@ -11,11 +11,11 @@
 #include "../graphics/PlanetSurface.hpp"
 #include "../graphics/SkyBox.hpp"
 #include "../graphics/SunSurface.hpp"
-#include "../math/GaloisLFSR.hpp"
 #include "../world/Resource.hpp"
 #include "../world/Set.hpp"
 #include "../world/TileType.hpp"
 
+#include <cstdint>
 #include <string>
 
 
@@ -34,14 +34,13 @@ namespace app {
 struct Assets {
 
 	std::string path;
+	std::string cache_path;
 	std::string data_path;
 	std::string font_path;
 	std::string skin_path;
 	std::string sky_path;
 	std::string tile_path;
 
-	math::GaloisLFSR random;
-
 	creature::NameGenerator name;
 
 	struct {
@@ -92,6 +91,13 @@ struct Assets {
 	void ReadPlanetProperty(const std::string &name, io::TokenStreamReader &, world::Planet &, world::Simulation &) const;
 	void ReadSunProperty(const std::string &name, io::TokenStreamReader &, world::Sun &, world::Simulation &) const;
 
+	/// identify the output of given generator for given planet
+	std::uint64_t PlanetCacheKey(const std::string &generator, const world::Planet &) const;
+	/// restore tiles from cache, returns false on miss
+	bool LoadPlanetCache(std::uint64_t key, world::Planet &) const;
+	/// store tiles, failure is not fatal since the cache is optional
+	void SavePlanetCache(std::uint64_t key, const world::Planet &) const;
+
 };
 
 }
@@ -53,6 +53,10 @@ public:
 	ui::TimePanel &GetTimePanel() noexcept { return tp; }
 	const ui::TimePanel &GetTimePanel() const noexcept { return tp; }
 
+	/// simulated seconds per real second
+	void TimeWarp(double w) noexcept { warp = w; }
+	double TimeWarp() const noexcept { return warp; }
+
 private:
 	void OnResize(int w, int h) override;
 
@@ -94,6 +98,7 @@ private:
 	int remain;
 	int thirds;
 	bool paused;
+	double warp;
 
 };
 
@@ -0,0 +1,68 @@
+#ifndef BLOBS_APP_THREADPOOL_HPP_
+#define BLOBS_APP_THREADPOOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace blobs {
+namespace app {
+
+class ThreadPool {
+
+public:
+	/// start given number of worker threads
+	/// with zero workers, everything runs on the calling thread
+	explicit ThreadPool(unsigned int workers = DefaultWorkers());
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator =(const ThreadPool &) = delete;
+
+	ThreadPool(ThreadPool &&) = delete;
+	ThreadPool &operator =(ThreadPool &&) = delete;
+
+public:
+	/// one less than the number of hardware threads
+	static unsigned int DefaultWorkers() noexcept;
+
+	unsigned int Workers() const noexcept { return threads.size(); }
+
+	/// call fn(i) for every i in [0,count), spread over the workers and
+	/// the calling thread, returns when all calls have finished
+	/// if a call throws, remaining calls are skipped and the first
+	/// exception is rethrown once all workers are done
+	void Run(int count, const std::function<void(int)> &fn);
+
+private:
+	void Work();
+	void Drain() noexcept;
+	void Join() noexcept;
+
+private:
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+
+	const std::function<void(int)> *job;
+	int count;
+	std::atomic<int> next;
+	unsigned int busy;
+	unsigned long generation;
+	bool stop;
+	/// first exception thrown by a call of the current job
+	std::exception_ptr error;
+
+};
+
+}
+}
+
+#endif
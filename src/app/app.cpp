@@ -1,16 +1,21 @@
 #include "Application.hpp"
 #include "Assets.hpp"
 #include "State.hpp"
+#include "ThreadPool.hpp"
 
 #include "init.hpp"
 #include "../graphics/Viewport.hpp"
+#include "../io/filesystem.hpp"
 #include "../io/Token.hpp"
 #include "../io/TokenStreamReader.hpp"
 #include "../world/Planet.hpp"
 #include "../world/Simulation.hpp"
 #include "../world/Sun.hpp"
 
+#include <cstdio>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <SDL.h>
 #include <SDL_image.h>
 
@@ -177,12 +182,12 @@ void State::OnQuit() {
 
 Assets::Assets()
 : path("assets/")
+, cache_path("cache/")
 , data_path(path + "data/")
 , font_path(path + "fonts/")
 , skin_path(path + "skins/")
 , sky_path(path + "skies/")
 , tile_path(path + "tiles/")
-, random(0x6283B64CEFE57925)
 , fonts{
 	graphics::Font(font_path + "DejaVuSans.ttf", 32),
 	graphics::Font(font_path + "DejaVuSans.ttf", 24),
@@ -220,6 +225,15 @@ Assets::Assets()
 	LoadTileTexture("wheat",    textures.tiles, 13);
 	textures.tiles.FilterTrilinear();
 
+	if (data.tile_types.Size() > graphics::PlanetSurface::MAX_TILE_TYPES) {
+		throw std::runtime_error("too many tile types");
+	}
+	shaders.planet_surface.Activate();
+	for (int id = 0; id < int(data.tile_types.Size()); ++id) {
+		const world::TileType &type = data.tile_types[id];
+		shaders.planet_surface.SetTileType(id, type.texture, type.shiny, type.glossy, type.metallic);
+	}
+
 	textures.skins.Bind();
 	textures.skins.Reserve(256, 256, 9, format);
 	LoadSkinTexture("plain", textures.skins, 0);
@@ -337,6 +351,16 @@ void Assets::ReadTileTypes(io::TokenStreamReader &in) {
 				data.tile_types[id].glossy = in.GetDouble();
 			} else if (name == "metallic") {
 				data.tile_types[id].metallic = in.GetDouble();
+			} else if (name == "capacity") {
+				data.tile_types[id].capacity = in.GetDouble();
+				if (!(data.tile_types[id].capacity > 0.0)) {
+					throw std::runtime_error("capacity of tile type " + data.tile_types[id].name + " must be positive");
+				}
+			} else if (name == "regrowth") {
+				data.tile_types[id].regrowth = in.GetDouble();
+				if (!(data.tile_types[id].regrowth >= 0.0)) {
+					throw std::runtime_error("regrowth of tile type " + data.tile_types[id].name + " must not be negative");
+				}
 			} else if (name == "yield") {
 				in.Skip(io::Token::BRACKET_OPEN);
 				while (in.Peek().type != io::Token::BRACKET_CLOSE) {
@@ -468,7 +492,35 @@ void Assets::LoadSkyTexture(const string &name, graphics::CubeMap &cm) const {
 	SDL_FreeSurface(srf);
 }
 
+namespace {
+
+/// 64 bit FNV-1a
+constexpr std::uint64_t hash_basis = 0xCBF29CE484222325;
+
+std::uint64_t hash(std::uint64_t h, const void *data, std::size_t size) noexcept {
+	const unsigned char *bytes = static_cast<const unsigned char *>(data);
+	for (std::size_t i = 0; i < size; ++i) {
+		h ^= bytes[i];
+		h *= 0x100000001B3;
+	}
+	return h;
+}
+
+std::uint64_t hash(std::uint64_t h, const string &s) noexcept {
+	// include the terminator so concatenations differ
+	return hash(h, s.c_str(), s.size() + 1);
+}
+
+template<class T>
+std::uint64_t hash(std::uint64_t h, T value) noexcept {
+	return hash(h, &value, sizeof(T));
+}
+
+}
+
 void Assets::LoadUniverse(const string &name, world::Simulation &sim) const {
+	// same universe, same creatures
+	sim.Seed(hash(hash_basis, name));
 	std::ifstream universe_file(data_path + name);
 	io::TokenStreamReader universe_reader(universe_file);
 	ReadBody(universe_reader, sim);
@@ -530,7 +582,11 @@ void Assets::ReadPlanetProperty(const std::string &name, io::TokenStreamReader &
 		string gen;
 		in.ReadIdentifier(gen);
 		if (gen == "earthlike") {
-			world::GenerateEarthlike(data.tile_types, planet);
+			const std::uint64_t key = PlanetCacheKey(gen, planet);
+			if (!LoadPlanetCache(key, planet)) {
+				world::GenerateEarthlike(data.tile_types, planet, sim.Pool());
+				SavePlanetCache(key, planet);
+			}
 		} else if (gen == "test") {
 			world::GenerateTest(data.tile_types, planet);
 		} else {
@@ -545,6 +601,102 @@ void Assets::ReadPlanetProperty(const std::string &name, io::TokenStreamReader &
 	}
 }
 
+namespace {
+
+/// bump when generator output or file layout changes
+constexpr std::uint32_t planet_cache_version = 1;
+/// written in native byte order, so a foreign cache fails this check
+constexpr std::uint32_t planet_cache_magic = 0x54504C42;
+
+struct PlanetCacheHeader {
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint64_t key;
+	std::int32_t sidelength;
+	std::int32_t padding;
+};
+
+string planet_cache_file(const string &dir, std::uint64_t key) {
+	std::stringstream s;
+	s << dir << std::hex << std::setw(16) << std::setfill('0') << key;
+	return s.str();
+}
+
+}
+
+std::uint64_t Assets::PlanetCacheKey(const string &gen, const world::Planet &planet) const {
+	std::uint64_t key = hash_basis;
+	key = hash(key, planet_cache_version);
+	key = hash(key, gen);
+	// everything the generators read from the planet
+	key = hash(key, planet.SideLength());
+	key = hash(key, planet.Radius());
+	// ice caps and climate zones depend on the tilt's x component only
+	key = hash(key, planet.AxialTilt().x);
+	for (int id = 0; id < int(data.tile_types.Size()); ++id) {
+		key = hash(key, data.tile_types[id].name);
+	}
+	return key;
+}
+
+bool Assets::LoadPlanetCache(std::uint64_t key, world::Planet &planet) const {
+	const string file_name = planet_cache_file(cache_path + "planets/", key);
+	const std::time_t mtime = io::file_mtime(file_name);
+	// stale if the tile types have been edited since
+	if (mtime == 0 || mtime < io::file_mtime(data_path + "tile_types")) {
+		return false;
+	}
+	std::ifstream file(file_name, std::ios::binary);
+	PlanetCacheHeader header;
+	if (!file.read(reinterpret_cast<char *>(&header), sizeof(header))
+		|| header.magic != planet_cache_magic
+		|| header.version != planet_cache_version
+		|| header.key != key
+		|| header.sidelength != planet.SideLength()
+	) {
+		return false;
+	}
+	if (!planet.ReadTiles(file)) {
+		return false;
+	}
+	for (int tile = 0; tile < planet.TileCount(); ++tile) {
+		if (planet.TileAt(tile).type >= data.tile_types.Size()) {
+			return false;
+		}
+	}
+	planet.BuildVAO();
+	return true;
+}
+
+void Assets::SavePlanetCache(std::uint64_t key, const world::Planet &planet) const {
+	const string dir = cache_path + "planets/";
+	if (!io::make_dirs(dir)) {
+		return;
+	}
+	const string file_name = planet_cache_file(dir, key);
+	// write aside and move in place so readers never see a partial file
+	const string temp_name = file_name + ".tmp";
+	{
+		std::ofstream file(temp_name, std::ios::binary);
+		PlanetCacheHeader header;
+		header.magic = planet_cache_magic;
+		header.version = planet_cache_version;
+		header.key = key;
+		header.sidelength = planet.SideLength();
+		header.padding = 0;
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		planet.WriteTiles(file);
+		if (!file) {
+			file.close();
+			io::remove_file(temp_name);
+			return;
+		}
+	}
+	if (std::rename(temp_name.c_str(), file_name.c_str()) != 0) {
+		io::remove_file(temp_name);
+	}
+}
+
 void Assets::ReadBodyProperty(const std::string &name, io::TokenStreamReader &in, world::Body &body, world::Simulation &sim) const {
 	if (name == "name") {
 		string value;
@@ -601,5 +753,113 @@ void Assets::ReadBodyProperty(const std::string &name, io::TokenStreamReader &in
 	}
 }
 
+
+ThreadPool::ThreadPool(unsigned int workers)
+: threads()
+, mutex()
+, wake()
+, done()
+, job(nullptr)
+, count(0)
+, next(0)
+, busy(0)
+, generation(0)
+, stop(false)
+, error() {
+	threads.reserve(workers);
+	try {
+		for (unsigned int i = 0; i < workers; ++i) {
+			threads.emplace_back(&ThreadPool::Work, this);
+		}
+	} catch (...) {
+		// the ones that did start must not outlive the pool
+		Join();
+		throw;
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	Join();
+}
+
+void ThreadPool::Join() noexcept {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	wake.notify_all();
+	for (auto &thread : threads) {
+		thread.join();
+	}
+}
+
+unsigned int ThreadPool::DefaultWorkers() noexcept {
+	// may return 0 if unknown
+	unsigned int hw = std::thread::hardware_concurrency();
+	return hw > 1 ? hw - 1 : 0;
+}
+
+void ThreadPool::Run(int n, const std::function<void(int)> &fn) {
+	if (threads.empty() || n < 2) {
+		for (int i = 0; i < n; ++i) {
+			fn(i);
+		}
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		job = &fn;
+		count = n;
+		next = 0;
+		busy = threads.size();
+		error = nullptr;
+		++generation;
+	}
+	wake.notify_all();
+	Drain();
+	std::exception_ptr e;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [this]() { return busy == 0; });
+		job = nullptr;
+		std::swap(e, error);
+	}
+	if (e) {
+		std::rethrow_exception(e);
+	}
+}
+
+void ThreadPool::Work() {
+	unsigned long seen = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this, seen]() { return stop || generation != seen; });
+			if (stop) return;
+			seen = generation;
+		}
+		Drain();
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--busy == 0) {
+			done.notify_one();
+		}
+	}
+}
+
+void ThreadPool::Drain() noexcept {
+	for (int i = next++; i < count; i = next++) {
+		try {
+			(*job)(i);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!error) {
+				error = std::current_exception();
+			}
+			// the job failed, skip what's left of it
+			next = count;
+		}
+	}
+}
+
 }
 }
@@ -43,7 +43,8 @@ MasterState::MasterState(Assets &assets, world::Simulation &sim) noexcept
 , tp(sim)
 , remain(0)
 , thirds(0)
-, paused(false) {
+, paused(false)
+, warp(1.0) {
 	bp.ZIndex(10.0f);
 	cp.ZIndex(20.0f);
 	rp.ZIndex(30.0f);
@@ -114,7 +115,8 @@ void MasterState::OnUpdate(int dt) {
 void MasterState::Tick() {
 	constexpr double dt = 0.01666666666666666666666666666666;
 	if (!paused) {
-		sim.Tick(dt);
+		sim.SetFocus(cam.Reference(), cam_focus, shown_creature);
+		sim.Tick(dt * warp);
 	}
 	remain -= FrameMS();
 	thirds = (thirds + 1) % 3;
@@ -173,6 +175,10 @@ void MasterState::OnKeyDown(const SDL_KeyboardEvent &e) {
 		paused = !paused;
 	} else if (e.keysym.sym == SDLK_F1) {
 		rp.Toggle();
+	} else if (e.keysym.sym == SDLK_PLUS || e.keysym.sym == SDLK_KP_PLUS) {
+		warp = std::min(warp * 2.0, 128.0);
+	} else if (e.keysym.sym == SDLK_MINUS || e.keysym.sym == SDLK_KP_MINUS) {
+		warp = std::max(warp * 0.5, 1.0);
 	}
 }
 
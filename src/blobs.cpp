@@ -18,7 +18,9 @@ int main(int argc, char *argv[]) {
 	blob->Name(assets.name.Sequential());
 	Spawn(*blob, sim.PlanetByName("Planet"));
 	// decrease chances of ur-blob dying without splitting
-	blob->GetProperties().Fertility() = 1.0;
+	creature::Genome::Properties<double> props(blob->GetProperties());
+	props.Fertility() = 1.0;
+	blob->SetProperties(props);
 	blob->BuildVAO();
 
 	app::MasterState state(assets, sim);
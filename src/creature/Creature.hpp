@@ -7,9 +7,11 @@
 #include "Situation.hpp"
 #include "Steering.hpp"
 #include "../graphics/SimpleVAO.hpp"
+#include "../math/GaloisLFSR.hpp"
 #include "../math/geometry.hpp"
 #include "../math/glm.hpp"
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -54,6 +56,15 @@ public:
 		bool Full() const noexcept { return value > 0.999999; }
 	};
 	struct Stats {
+		enum Index {
+			DAMAGE,
+			BREATH,
+			THIRST,
+			HUNGER,
+			EXHAUSTION,
+			FATIGUE,
+			BOREDOM,
+		};
 		Stat stat[7];
 		Stat &Damage() noexcept { return stat[0]; }
 		const Stat &Damage() const noexcept { return stat[0]; }
@@ -72,7 +83,10 @@ public:
 	};
 
 public:
+	/// creature founding a new lineage
 	explicit Creature(world::Simulation &);
+	/// creature with given lineage, see Lineage()
+	Creature(world::Simulation &, std::uint64_t lineage);
 	~Creature();
 
 	Creature(const Creature &) = delete;
@@ -88,11 +102,20 @@ public:
 	void Name(const std::string &n) noexcept { name = n; }
 	const std::string &Name() const noexcept { return name; }
 
+	/// identifies the creature by its ancestry, together with the
+	/// simulation's seed this determines its random stream
+	std::uint64_t Lineage() const noexcept { return lineage; }
+	/// lineage of this creature's nth offspring
+	std::uint64_t OffspringLineage(int n) const noexcept;
+	/// the creature's own random stream, draws from it don't depend
+	/// on the order in which creatures are updated
+	math::GaloisLFSR &Random() noexcept { return random; }
+
 	Genome &GetGenome() noexcept { return genome; }
 	const Genome &GetGenome() const noexcept { return genome; }
 
-	Genome::Properties<double> &GetProperties() noexcept { return properties; }
 	const Genome::Properties<double> &GetProperties() const noexcept { return properties; }
+	void SetProperties(const Genome::Properties<double> &p) noexcept { properties = p; derived.valid = false; }
 
 	void AddMass(int res, double amount);
 	const Composition &GetComposition() const noexcept { return composition; }
@@ -164,8 +187,12 @@ public:
 	void AddParent(Creature &);
 	const std::vector<Creature *> &Parents() const noexcept { return parents; }
 
-	Stats &GetStats() noexcept { return stats; }
-	const Stats &GetStats() const noexcept { return stats; }
+	/// stats are evaluated lazily, this brings them up to date first
+	const Stats &GetStats() const noexcept;
+	/// adjust value of given stat (see Stats::Index) by delta
+	void AddStat(int stat, double delta) noexcept;
+	/// set gain per second of given stat (see Stats::Index)
+	void StatGain(int stat, double gain) noexcept;
 
 	Memory &GetMemory() noexcept { return memory; }
 	const Memory &GetMemory() const noexcept { return memory; }
@@ -177,7 +204,22 @@ public:
 	void AddGoal(std::unique_ptr<Goal> &&);
 	const std::vector<std::unique_ptr<Goal>> &Goals() const noexcept { return goals; }
 
+	/// same as TickMotion(dt) followed by TickLife()
 	void Tick(double dt);
+	/// first half of Tick(): movement, only touches this creature
+	void TickMotion(double dt);
+	/// second half of Tick(): stats and brain, may touch the simulation
+	void TickLife();
+	/// simulation time of the last call to Tick()
+	double LastTick() const noexcept { return last_tick; }
+	/// simulation time of the last call to TickLife()
+	double LastLifeTick() const noexcept { return last_life_tick; }
+	/// time passed since the previous update, only meaningful during Tick()
+	double TickDelta() const noexcept { return tick_delta; }
+	/// offset for spreading updates over ticks, see Simulation::DueForTick()
+	unsigned int TickPhase() const noexcept { return tick_phase; }
+	/// handle stats having changed fatally since the last tick
+	void CheckStats() noexcept;
 
 	Situation &GetSituation() noexcept { return situation; }
 	const Situation &GetSituation() const noexcept { return situation; }
@@ -199,15 +241,39 @@ public:
 	void Draw(graphics::Viewport &);
 
 private:
+	/// values depending on properties, stats, and age
+	/// updated once per tick and whenever one of those changes
+	struct DerivedAttributes {
+		bool valid = false;
+		double age_factor = 1.0;
+		double energy_efficiency = 0.25;
+		double exhaustion_factor = 1.0;
+		double fatigue_factor = 1.0;
+		double strength = 0.0;
+		double stamina = 0.0;
+		double dexerty = 0.0;
+		double intelligence = 0.0;
+	};
+
 	void Cache() noexcept;
+	void UpdateDerived() const noexcept;
+	const DerivedAttributes &Derived() const noexcept;
 	void TickState(double dt);
 	void TickStats(double dt);
+	/// advance stats to current simulation time
+	void SyncStats() const noexcept;
+	/// time of next stat change the simulation must react to
+	void UpdateStatsDeadline() noexcept;
+	/// stat values or gains were changed from outside
+	void StatsChanged() noexcept;
 	void TickBrain(double dt);
 	Situation::Derivative Step(const Situation::Derivative &ds, double dt) const noexcept;
 
 private:
 	world::Simulation &sim;
 	std::string name;
+	std::uint64_t lineage;
+	math::GaloisLFSR random;
 
 	Genome genome;
 	Genome::Properties<double> properties;
@@ -223,12 +289,21 @@ private:
 
 	double birth;
 	double death;
+	double last_tick;
+	double last_life_tick;
+	double tick_delta;
+	unsigned int tick_phase;
 	Callback on_death;
 	bool removable;
 
 	std::vector<Creature *> parents;
 
-	Stats stats;
+	/// stat values as of stats_time, they change linearly
+	/// with their gain apart from damage when others are full
+	mutable Stats stats;
+	mutable double stats_time;
+	double stats_deadline;
+	bool stats_resting;
 	Memory memory;
 
 	std::unique_ptr<Goal> bg_task;
@@ -238,6 +313,10 @@ private:
 	Steering steering;
 	glm::dvec3 heading_target;
 	bool heading_manual;
+	/// how long the creature has been standing still
+	double idle_time;
+
+	mutable DerivedAttributes derived;
 
 	// cached because steering makes heavy use of this
 	double perception_range;
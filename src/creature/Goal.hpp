@@ -28,7 +28,6 @@ public:
 public:
 	Creature &GetCreature() noexcept { return c; }
 	const Creature &GetCreature() const noexcept { return c; }
-	Creature::Stats &GetStats() noexcept { return c.GetStats(); }
 	const Creature::Stats &GetStats() const noexcept { return c.GetStats(); }
 	Situation &GetSituation() noexcept { return c.GetSituation(); }
 	const Situation &GetSituation() const noexcept { return c.GetSituation(); }
@@ -16,7 +16,8 @@ class IngestGoal
 : public Goal {
 
 public:
-	explicit IngestGoal(Creature &, Creature::Stat &);
+	/// stat is one of Creature::Stats::Index
+	IngestGoal(Creature &, int stat);
 	~IngestGoal() override;
 
 public:
@@ -29,13 +30,16 @@ public:
 
 private:
 	bool OnSuitableTile();
+	const Creature::Stat &GetStat() const noexcept { return GetStats().stat[stat]; }
 
 private:
-	Creature::Stat &stat;
+	/// index of the stat this goal tries to lower
+	int stat;
 	Composition accept;
 	LocateResourceGoal *locate_subtask;
 	bool ingesting;
 
+	int tile;
 	int resource;
 	double yield;
 
@@ -19,6 +19,11 @@ public:
 	void SetMinimum(double m) noexcept { minimum = m; }
 	void Accept(int resource, double attractiveness);
 
+	/// whether a suitable spot has been found
+	bool Found() const noexcept { return found; }
+	/// where the creature is headed
+	const glm::dvec3 &Target() const noexcept { return target_pos; }
+
 	std::string Describe() const override;
 	void Enable() override;
 	void Tick(double dt) override;
@@ -3,8 +3,6 @@
 
 #include "../math/glm.hpp"
 
-#include <map>
-
 
 namespace blobs {
 namespace world {
@@ -17,6 +15,11 @@ class Creature;
 class Memory {
 
 public:
+	/// number of tile types remembered at most
+	static constexpr int MAX_TYPES = 16;
+	/// number of other creatures remembered at most
+	static constexpr int MAX_CREATURES = 8;
+
 	struct Location {
 		world::Planet *planet;
 		glm::dvec3 position;
@@ -40,25 +43,48 @@ public:
 	void Tick(double dt);
 
 private:
-	/// track time spent on a tile
-	void TrackStay(const Location &, double t);
+	/// start tracking a stay on given tile
+	void EnterTile(const Location &);
+	/// credit time spent on the current tile to its type
+	void LeaveTile();
+
+	/// find slot for given tile type, -1 if not known
+	int FindType(int type) const noexcept;
+	/// find slot for given creature, inserting or evicting as needed
+	int ProfileOf(Creature &);
+
+	/// weight of a memory last refreshed at given time
+	double Decay(double since) const noexcept;
 
 private:
 	Creature &c;
 
 	struct Stay {
+		int type;
 		double first_been;
 		Location first_loc;
 		double last_been;
 		Location last_loc;
 		double time_spent;
 	};
-	std::map<int, Stay> known_types;
+	Stay known_types[MAX_TYPES];
+	int num_types;
+
 	struct Profile {
-		double annoyance = 0.0;
-		double familiarity = 0.0;
+		Creature *other;
+		double last_seen;
+		double annoyance;
+		double familiarity;
 	};
-	std::map<Creature *, Profile> known_creatures;
+	Profile known_creatures[MAX_CREATURES];
+	int num_creatures;
+
+	/// tile the creature is currently on, stays are only
+	/// tracked when this changes
+	const world::Planet *cur_planet;
+	int cur_tile;
+	int cur_type;
+	double cur_time;
 
 };
 
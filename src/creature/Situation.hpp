@@ -68,6 +68,13 @@ public:
 	void Accelerate(const glm::dvec3 &dv) noexcept;
 	void EnforceConstraints(State &) const noexcept;
 
+	/// resting creatures are not integrated until woken up
+	bool Resting() const noexcept { return resting; }
+	/// stop all movement and start resting
+	void Rest() noexcept;
+	/// resume integration, happens automatically on Move and Accelerate
+	void Wake() noexcept { resting = false; }
+
 	void Heading(const glm::dvec3 &h) noexcept { state.dir = h; }
 	const glm::dvec3 &Heading() const noexcept { return state.dir; }
 
@@ -76,6 +83,7 @@ public:
 public:
 	world::Planet *planet;
 	State state;
+	bool resting;
 	enum {
 		LOST,
 		PLANET_SURFACE,
@@ -36,6 +36,9 @@ public:
 	void Pass(const glm::dvec3 &) noexcept;
 	void GoTo(const glm::dvec3 &) noexcept;
 
+	/// true if trying to get somewhere
+	bool Active() const noexcept { return seeking || arriving; }
+
 	glm::dvec3 Force(const Situation::State &) const noexcept;
 
 private:
@@ -13,13 +13,17 @@
 #include "../app/Assets.hpp"
 #include "../graphics/color.hpp"
 #include "../math/const.hpp"
+#include "../math/Integrator.hpp"
 #include "../ui/string.hpp"
 #include "../world/Body.hpp"
 #include "../world/Planet.hpp"
 #include "../world/Simulation.hpp"
 #include "../world/TileType.hpp"
+#include "../world/TileVicinity.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <sstream>
 #include <glm/gtx/rotate_vector.hpp>
 #include <glm/gtx/transform.hpp>
@@ -126,9 +130,27 @@ double Composition::Compatibility(int res) const noexcept {
 }
 
 
+namespace {
+
+/// scramble bits of x, used to derive unrelated seeds from similar numbers
+std::uint64_t mix(std::uint64_t x) noexcept {
+	x += 0x9E3779B97F4A7C15;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+	return x ^ (x >> 31);
+}
+
+}
+
 Creature::Creature(world::Simulation &sim)
+: Creature(sim, sim.NextLineage()) {
+}
+
+Creature::Creature(world::Simulation &sim, std::uint64_t lineage)
 : sim(sim)
 , name()
+, lineage(lineage)
+, random(mix(sim.Seed() ^ mix(lineage)))
 , genome()
 , properties()
 , composition(sim.Resources())
@@ -138,10 +160,17 @@ Creature::Creature(world::Simulation &sim)
 , size(1.0)
 , birth(sim.Time())
 , death(-1.0)
+, last_tick(sim.Time())
+, last_life_tick(sim.Time())
+, tick_delta(0.0)
+, tick_phase(sim.LiveCreatures().size())
 , on_death()
 , removable(false)
 , parents()
 , stats()
+, stats_time(sim.Time())
+, stats_deadline(sim.Time())
+, stats_resting(true)
 , memory(*this)
 , bg_task()
 , goals()
@@ -149,6 +178,8 @@ Creature::Creature(world::Simulation &sim)
 , steering(*this)
 , heading_target(0.0, 0.0, -1.0)
 , heading_manual(false)
+, idle_time(0.0)
+, derived()
 , perception_range(1.0)
 , perception_range_squared(1.0)
 , perception_omni_range(1.0)
@@ -163,6 +194,11 @@ Creature::Creature(world::Simulation &sim)
 Creature::~Creature() {
 }
 
+std::uint64_t Creature::OffspringLineage(int n) const noexcept {
+	// hash both, so no two parents share an offspring's lineage
+	return mix(lineage ^ mix(std::uint64_t(n) + 1));
+}
+
 void Creature::AddMass(int res, double amount) {
 	composition.Add(res, amount);
 	double nonsolid = 0.0;
@@ -190,7 +226,6 @@ void Creature::Ingest(int res, double amount) noexcept {
 		// 10% of fluids stays in body
 		AddMass(res, amount * 0.1 * composition.Compatibility(res));
 	}
-	math::GaloisLFSR &random = sim.Assets().random;
 	if (random.UNorm() < AdaptChance()) {
 		// change color to be slightly more like resource
 		glm::dvec3 color(rgb2hsl(sim.Resources()[res].base_color));
@@ -258,7 +293,7 @@ void Creature::Ingest(int res, double amount) noexcept {
 }
 
 void Creature::DoWork(double amount) noexcept {
-	stats.Exhaustion().Add(amount / (Stamina() + 1.0));
+	AddStat(Stats::EXHAUSTION, amount / (Stamina() + 1.0));
 	// burn resources proportional to composition
 	// factor = 1/total * 1/efficiency * amount * -1
 	double factor = -amount / (composition.TotalMass() * EnergyEfficiency());
@@ -271,10 +306,11 @@ void Creature::DoWork(double amount) noexcept {
 	}
 	// doing work improves strength a little
 	properties.Strength() += amount * 0.0001;
+	derived.valid = false;
 }
 
 void Creature::Hurt(double amount) noexcept {
-	stats.Damage().Add(amount);
+	AddStat(Stats::DAMAGE, amount);
 	if (stats.Damage().Full()) {
 		Die();
 	}
@@ -343,20 +379,19 @@ double Creature::AgeFactor(double peak) const noexcept {
 }
 
 double Creature::EnergyEfficiency() const noexcept {
-	return 0.25 * AgeFactor(0.05);
+	return Derived().energy_efficiency;
 }
 
 double Creature::ExhaustionFactor() const noexcept {
-	return 1.0 - (glm::smoothstep(0.5, 1.0, stats.Exhaustion().value) * 0.5);
+	return Derived().exhaustion_factor;
 }
 
 double Creature::FatigueFactor() const noexcept {
-	return 1.0 - (glm::smoothstep(0.5, 1.0, stats.Fatigue().value) * 0.5);
+	return Derived().fatigue_factor;
 }
 
 double Creature::Strength() const noexcept {
-	// TODO: replace all age factors with actual growth and decay
-	return properties.Strength() * ExhaustionFactor() * AgeFactor(0.25);
+	return Derived().strength;
 }
 
 double Creature::StrengthFactor() const noexcept {
@@ -365,7 +400,7 @@ double Creature::StrengthFactor() const noexcept {
 }
 
 double Creature::Stamina() const noexcept {
-	return properties.Stamina() * ExhaustionFactor() * AgeFactor(0.25);
+	return Derived().stamina;
 }
 
 double Creature::StaminaFactor() const noexcept {
@@ -374,7 +409,7 @@ double Creature::StaminaFactor() const noexcept {
 }
 
 double Creature::Dexerty() const noexcept {
-	return properties.Dexerty() * ExhaustionFactor() * AgeFactor(0.25);
+	return Derived().dexerty;
 }
 
 double Creature::DexertyFactor() const noexcept {
@@ -383,7 +418,7 @@ double Creature::DexertyFactor() const noexcept {
 }
 
 double Creature::Intelligence() const noexcept {
-	return properties.Intelligence() * FatigueFactor() * AgeFactor(0.25);
+	return Derived().intelligence;
 }
 
 double Creature::IntelligenceFactor() const noexcept {
@@ -396,7 +431,7 @@ double Creature::Lifetime() const noexcept {
 }
 
 double Creature::Fertility() const noexcept {
-	return properties.Fertility() * AgeFactor(0.25);
+	return properties.Fertility() * Derived().age_factor;
 }
 
 double Creature::Mutability() const noexcept {
@@ -432,11 +467,11 @@ bool Creature::PerceptionTest(const glm::dvec3 &p) const noexcept {
 }
 
 double Creature::OffspringChance() const noexcept {
-	return AgeFactor(0.25) * properties.Fertility() * (1.0 / 3600.0);
+	return Derived().age_factor * properties.Fertility() * (1.0 / 60.0) * tick_delta;
 }
 
 double Creature::MutateChance() const noexcept {
-	return GetProperties().Mutability() * (1.0 / 3600.0);
+	return GetProperties().Mutability() * (1.0 / 60.0) * tick_delta;
 }
 
 double Creature::AdaptChance() const noexcept {
@@ -468,13 +503,26 @@ bool GoalCompare(const std::unique_ptr<Goal> &a, const std::unique_ptr<Goal> &b)
 }
 
 void Creature::Tick(double dt) {
+	TickMotion(dt);
+	TickLife();
+}
+
+void Creature::TickMotion(double dt) {
+	last_tick = sim.Time();
+	tick_delta = dt;
 	Cache();
 	TickState(dt);
-	TickStats(dt);
-	TickBrain(dt);
+}
+
+void Creature::TickLife() {
+	last_life_tick = sim.Time();
+	TickStats(tick_delta);
+	TickBrain(tick_delta);
 }
 
 void Creature::Cache() noexcept {
+	// age changes every tick
+	UpdateDerived();
 	double dex_fact = DexertyFactor();
 	perception_range = 3.0 * dex_fact + size;
 	perception_range_squared = perception_range * perception_range;
@@ -484,21 +532,62 @@ void Creature::Cache() noexcept {
 	perception_field = 0.8 - dex_fact;
 }
 
+void Creature::UpdateDerived() const noexcept {
+	// TODO: replace all age factors with actual growth and decay
+	derived.age_factor = AgeFactor(0.25);
+	derived.energy_efficiency = 0.25 * AgeFactor(0.05);
+	const Stats &stats = GetStats();
+	derived.exhaustion_factor = 1.0 - (glm::smoothstep(0.5, 1.0, stats.Exhaustion().value) * 0.5);
+	derived.fatigue_factor = 1.0 - (glm::smoothstep(0.5, 1.0, stats.Fatigue().value) * 0.5);
+	derived.strength = properties.Strength() * derived.exhaustion_factor * derived.age_factor;
+	derived.stamina = properties.Stamina() * derived.exhaustion_factor * derived.age_factor;
+	derived.dexerty = properties.Dexerty() * derived.exhaustion_factor * derived.age_factor;
+	derived.intelligence = properties.Intelligence() * derived.fatigue_factor * derived.age_factor;
+	derived.valid = true;
+}
+
+const Creature::DerivedAttributes &Creature::Derived() const noexcept {
+	if (!derived.valid) {
+		UpdateDerived();
+	}
+	return derived;
+}
+
+namespace {
+
+/// longest step a creature's motion is integrated with, in multiples
+/// of the simulation's max step
+constexpr double max_motion_steps = 4.0;
+
+}
+
 void Creature::TickState(double dt) {
 	steering.MaxSpeed(Dexerty());
 	steering.MaxForce(Strength());
+	if (situation.Resting() && steering.Active()) {
+		situation.Wake();
+	}
 	Situation::State state(situation.GetState());
-	Situation::Derivative a(Step(Situation::Derivative(), 0.0));
-	Situation::Derivative b(Step(a, dt * 0.5));
-	Situation::Derivative c(Step(b, dt * 0.5));
-	Situation::Derivative d(Step(c, dt));
-	Situation::Derivative f(
-		(1.0 / 6.0) * (a.vel + 2.0 * (b.vel + c.vel) + d.vel),
-		(1.0 / 6.0) * (a.acc + 2.0 * (b.acc + c.acc) + d.acc)
-	);
-	state.pos += f.vel * dt;
-	state.vel += f.acc * dt;
-	situation.EnforceConstraints(state);
+	double work = 0.0;
+	if (!situation.Resting()) {
+		// creatures far from focus tick less often, split their
+		// longer steps so the integration stays stable
+		const int substeps = std::max(1, int(std::ceil(dt / (sim.MaxStep() * max_motion_steps) - 1.0e-9)));
+		const double step = dt / substeps;
+		const math::Integrator method = sim.GetIntegrator(*this);
+		for (int i = 0; i < substeps; ++i) {
+			Situation::Derivative f(math::Integrate<Situation::Derivative>(method,
+				[this](const Situation::Derivative &ds, double t) { return Step(ds, t); },
+				step));
+			state.pos += f.vel * step;
+			state.vel += f.acc * step;
+			situation.EnforceConstraints(state);
+			situation.SetState(state);
+			// work is force times distance
+			// keep 10% of gravity as a kind of background burn
+			work += glm::length(f.acc - (0.9 * situation.GetPlanet().GravityAt(state.pos))) * Mass() * glm::length(f.vel) * step;
+		}
+	}
 
 	if (!heading_manual && glm::length2(state.vel) > 0.000001) {
 		const glm::dvec3 normal(situation.GetPlanet().NormalAt(state.pos));
@@ -517,9 +606,20 @@ void Creature::TickState(double dt) {
 	}
 
 	situation.SetState(state);
-	// work is force times distance
-	// keep 10% of gravity as a kind of background burn
-	DoWork(glm::length(f.acc - (0.9 * situation.GetPlanet().GravityAt(state.pos))) * Mass() * glm::length(f.vel) * dt);
+	if (situation.Resting()) {
+		return;
+	}
+	DoWork(work);
+
+	// park if standing around for a while
+	if (!steering.Active() && !situation.Moving() && situation.OnGround()) {
+		idle_time += dt;
+		if (idle_time > 0.5) {
+			situation.Rest();
+		}
+	} else {
+		idle_time = 0.0;
+	}
 }
 
 Situation::Derivative Creature::Step(const Situation::Derivative &ds, double dt) const noexcept {
@@ -550,27 +650,108 @@ Situation::Derivative Creature::Step(const Situation::Derivative &ds, double dt)
 	};
 }
 
+namespace {
+
+// TODO: damage values depending on properties
+/// damage per second taken while breath, thirst, or hunger is full
+constexpr double stat_dps[3] = { 1.0 / 4.0, 1.0 / 32.0, 1.0 / 128.0 };
+
+}
+
+const Creature::Stats &Creature::GetStats() const noexcept {
+	SyncStats();
+	return stats;
+}
+
+void Creature::AddStat(int stat, double delta) noexcept {
+	SyncStats();
+	stats.stat[stat].Add(delta);
+	StatsChanged();
+}
+
+void Creature::StatGain(int stat, double gain) noexcept {
+	SyncStats();
+	stats.stat[stat].gain = gain;
+	StatsChanged();
+}
+
+void Creature::StatsChanged() noexcept {
+	derived.valid = false;
+	// have CheckStats find the next deadline
+	stats_deadline = sim.Time();
+}
+
 void Creature::TickStats(double dt) {
-	for (auto &s : stats.stat) {
-		s.Add(s.gain * dt);
+	const bool resting = !situation.Moving();
+	if (resting != stats_resting) {
+		// recovery rate changes, catch up using the old one
+		SyncStats();
+		stats_resting = resting;
+		stats_deadline = sim.Time();
 	}
-	// TODO: damage values depending on properties
-	if (stats.Breath().Full()) {
-		constexpr double dps = 1.0 / 4.0;
-		Hurt(dps * dt);
+	CheckStats();
+}
+
+void Creature::CheckStats() noexcept {
+	if (Dead() || sim.Time() < stats_deadline) {
+		// nothing interesting happening
+		return;
 	}
-	if (stats.Thirst().Full()) {
-		constexpr double dps = 1.0 / 32.0;
-		Hurt(dps * dt);
+	SyncStats();
+	if (stats.Damage().Full()) {
+		Die();
+		return;
 	}
-	if (stats.Hunger().Full()) {
-		constexpr double dps = 1.0 / 128.0;
-		Hurt(dps * dt);
+	UpdateStatsDeadline();
+}
+
+void Creature::SyncStats() const noexcept {
+	double remaining = Dead() ? 0.0 : sim.Time() - stats_time;
+	stats_time = sim.Time();
+	// stats change linearly with their gain, except for damage which
+	// additionally rises while breath, thirst, or hunger is full, so
+	// step from one of those filling up to the next
+	while (remaining > 0.0) {
+		double step = remaining;
+		double dps = 0.0;
+		for (int i = 0; i < 3; ++i) {
+			const Stat &s = stats.stat[i + 1];
+			if (s.Full()) {
+				dps += stat_dps[i];
+			} else if (s.gain > 0.0) {
+				step = std::min(step, (1.0 - s.value) / s.gain);
+			}
+		}
+		for (int i = 1; i < 7; ++i) {
+			stats.stat[i].Add(stats.stat[i].gain * step);
+		}
+		if (stats_resting) {
+			// double exhaustion recovery when standing still
+			stats.Exhaustion().Add(stats.Exhaustion().gain * step);
+		}
+		stats.Damage().Add((stats.Damage().gain + dps) * step);
+		remaining -= step;
 	}
-	if (!situation.Moving()) {
-		// double exhaustion recovery when standing still
-		stats.Exhaustion().Add(stats.Exhaustion().gain * dt);
+}
+
+void Creature::UpdateStatsDeadline() noexcept {
+	double next = std::numeric_limits<double>::infinity();
+	double dps = 0.0;
+	for (int i = 0; i < 3; ++i) {
+		const Stat &s = stats.stat[i + 1];
+		if (s.Full()) {
+			dps += stat_dps[i];
+		} else if (s.gain > 0.0) {
+			// damage rate changes
+			next = std::min(next, (1.0 - s.value) / s.gain);
+		}
+	}
+	const double damage_rate = stats.Damage().gain + dps;
+	if (damage_rate > 0.0) {
+		// time of death
+		next = std::min(next, (1.0 - stats.Damage().value) / damage_rate);
 	}
+	stats_deadline = stats_time + next;
 }
 
 void Creature::TickBrain(double dt) {
@@ -747,15 +928,11 @@ void Spawn(Creature &c, world::Planet &p) {
 	c.HeadingTarget(glm::dvec3(1.0, 0.0, 0.0));
 
 	// probe surrounding area for common resources
-	int start = p.SideLength() / 2 - 2;
-	int end = start + 5;
 	std::map<int, double> yields;
-	for (int y = start; y < end; ++y) {
-		for (int x = start; x < end; ++x) {
-			const world::TileType &t = p.TypeAt(0, x, y);
-			for (auto yield : t.resources) {
-				yields[yield.resource] += yield.ubiquity;
-			}
+	for (int tile : world::TileVicinity(p, p.TileIndexAt(c.GetSituation().Position()), 3)) {
+		const world::TileType &t = p.TypeAt(tile);
+		for (auto yield : t.resources) {
+			yields[yield.resource] += yield.ubiquity;
 		}
 	}
 	int liquid = -1;
@@ -823,18 +1000,18 @@ void Spawn(Creature &c, world::Planet &p) {
 void Genome::Configure(Creature &c) const {
 	c.GetGenome() = *this;
 
-	math::GaloisLFSR &random = c.GetSimulation().Assets().random;
+	math::GaloisLFSR &random = c.Random();
 
-	c.GetProperties() = Instantiate(properties, random);
+	c.SetProperties(Instantiate(properties, random));
 
 	// TODO: derive stats from properties
-	c.GetStats().Damage().gain = (-1.0 / 100.0);
-	c.GetStats().Breath().gain = (1.0 / 5.0);
-	c.GetStats().Thirst().gain = (1.0 / 60.0);
-	c.GetStats().Hunger().gain = (1.0 / 200.0);
-	c.GetStats().Exhaustion().gain = (-1.0 / 100.0);
-	c.GetStats().Fatigue().gain = (-1.0 / 100.0);
-	c.GetStats().Boredom().gain = (1.0 / 300.0);
+	c.StatGain(Creature::Stats::DAMAGE, -1.0 / 100.0);
+	c.StatGain(Creature::Stats::BREATH, 1.0 / 5.0);
+	c.StatGain(Creature::Stats::THIRST, 1.0 / 60.0);
+	c.StatGain(Creature::Stats::HUNGER, 1.0 / 200.0);
+	c.StatGain(Creature::Stats::EXHAUSTION, -1.0 / 100.0);
+	c.StatGain(Creature::Stats::FATIGUE, -1.0 / 100.0);
+	c.StatGain(Creature::Stats::BOREDOM, 1.0 / 300.0);
 
 	glm::dvec3 base_color(
 		std::fmod(base_hue.FakeNormal(random.SNorm()) + 1.0, 1.0),
@@ -856,7 +1033,7 @@ void Genome::Configure(Creature &c) const {
 
 
 void Split(Creature &c) {
-	Creature *a = new Creature(c.GetSimulation());
+	Creature *a = new Creature(c.GetSimulation(), c.OffspringLineage(0));
 	const Situation &s = c.GetSituation();
 	a->AddParent(c);
 	a->Name(c.GetSimulation().Assets().name.Sequential());
@@ -875,7 +1052,7 @@ void Split(Creature &c) {
 	a->BuildVAO();
 	c.GetSimulation().Log() << a->Name() << " was born" << std::endl;
 
-	Creature *b = new Creature(c.GetSimulation());
+	Creature *b = new Creature(c.GetSimulation(), c.OffspringLineage(1));
 	b->AddParent(c);
 	b->Name(c.GetSimulation().Assets().name.Sequential());
 	c.GetGenome().Configure(*b);
@@ -897,40 +1074,54 @@ void Split(Creature &c) {
 
 
 Memory::Memory(Creature &c)
-: c(c) {
+: c(c)
+, num_types(0)
+, num_creatures(0)
+, cur_planet(nullptr)
+, cur_tile(-1)
+, cur_type(-1)
+, cur_time(0.0) {
 }
 
 Memory::~Memory() {
 }
 
 void Memory::Erase() {
-	known_types.clear();
-	known_creatures.clear();
+	num_types = 0;
+	num_creatures = 0;
+	cur_planet = nullptr;
+	cur_tile = -1;
+	cur_type = -1;
+	cur_time = 0.0;
 }
 
 bool Memory::RememberLocation(const Composition &accept, glm::dvec3 &pos) const noexcept {
+	const double now = c.GetSimulation().Time();
 	double best_rating = -1.0;
-	for (const auto &k : known_types) {
-		const world::TileType &t = c.GetSimulation().TileTypes()[k.first];
+	for (int i = 0; i < num_types; ++i) {
+		const Stay &k = known_types[i];
+		const world::TileType &t = c.GetSimulation().TileTypes()[k.type];
 		auto entry = t.FindBestResource(accept);
 		if (entry != t.resources.end()) {
-			double rating = entry->ubiquity / std::max(0.125, 0.25 * glm::length2(c.GetSituation().Position() - k.second.first_loc.position));
+			// older memories are less reliable
+			const double certainty = Decay(now - k.last_been);
+			double rating = certainty * entry->ubiquity / std::max(0.125, 0.25 * glm::length2(c.GetSituation().Position() - k.first_loc.position));
 			if (rating > best_rating) {
 				best_rating = rating;
-				pos = k.second.first_loc.position;
+				pos = k.first_loc.position;
 			}
-			rating = entry->ubiquity / std::max(0.125, 0.25 * glm::length2(c.GetSituation().Position() - k.second.last_loc.position));
+			rating = certainty * entry->ubiquity / std::max(0.125, 0.25 * glm::length2(c.GetSituation().Position() - k.last_loc.position));
 			if (rating > best_rating) {
 				best_rating = rating;
-				pos = k.second.last_loc.position;
+				pos = k.last_loc.position;
 			}
 		}
 	}
 	if (best_rating > 0.0) {
 		glm::dvec3 error(
-			c.GetSimulation().Assets().random.SNorm(),
-			c.GetSimulation().Assets().random.SNorm(),
-			c.GetSimulation().Assets().random.SNorm());
+			c.Random().SNorm(),
+			c.Random().SNorm(),
+			c.Random().SNorm());
 		pos += error * (4.0 * (1.0 - c.IntelligenceFactor()));
 		pos = glm::normalize(pos) * c.GetSituation().GetPlanet().Radius();
 		return true;
@@ -942,10 +1133,10 @@ bool Memory::RememberLocation(const Composition &accept, glm::dvec3 &pos) const
 void Memory::TrackCollision(Creature &other) {
 	// TODO: find out whose fault it was
 	// TODO: source values from personality
-	Profile &p = known_creatures[&other];
+	Profile &p = known_creatures[ProfileOf(other)];
 	p.annoyance += 0.1;
 	const double annoy_fact = p.annoyance / (p.annoyance + 1.0);
-	if (c.GetSimulation().Assets().random.UNorm() > annoy_fact * 0.1 * (1.0 - c.GetStats().Damage().value)) {
+	if (c.Random().UNorm() > annoy_fact * 0.1 * (1.0 - c.GetStats().Damage().value)) {
 		AttackGoal *g = new AttackGoal(c, other);
 		g->SetDamageTarget(annoy_fact);
 		g->Urgency(annoy_fact);
@@ -956,41 +1147,121 @@ void Memory::TrackCollision(Creature &other) {
 
 void Memory::Tick(double dt) {
 	Situation &s = c.GetSituation();
-	if (s.OnSurface()) {
-		TrackStay({ &s.GetPlanet(), s.Position() }, dt);
+	if (!s.OnSurface()) {
+		LeaveTile();
+		return;
 	}
-	// TODO: forget
-}
-
-void Memory::TrackStay(const Location &l, double t) {
-	const world::TileType &type = l.planet->TileTypeAt(l.position);
-	auto entry = known_types.find(type.id);
-	if (entry != known_types.end()) {
-		if (c.GetSimulation().Time() - entry->second.last_been > c.GetProperties().Lifetime() * 0.1) {
+	const int tile = s.GetPlanet().TileIndexAt(s.Position());
+	if (&s.GetPlanet() == cur_planet && tile == cur_tile) {
+		cur_time += dt;
+		return;
+	}
+	LeaveTile();
+	EnterTile({ &s.GetPlanet(), s.Position() });
+	cur_planet = &s.GetPlanet();
+	cur_tile = tile;
+	cur_time = dt;
+}
+
+void Memory::LeaveTile() {
+	if (cur_type >= 0) {
+		const int slot = FindType(cur_type);
+		if (slot >= 0) {
+			known_types[slot].last_been = c.GetSimulation().Time();
+			known_types[slot].time_spent += cur_time;
+		}
+	}
+	cur_planet = nullptr;
+	cur_tile = -1;
+	cur_type = -1;
+	cur_time = 0.0;
+}
+
+void Memory::EnterTile(const Location &l) {
+	const double now = c.GetSimulation().Time();
+	cur_type = l.planet->TileAt(l.position).type;
+	int slot = FindType(cur_type);
+	if (slot >= 0) {
+		Stay &stay = known_types[slot];
+		if (now - stay.last_been > c.GetProperties().Lifetime() * 0.1) {
 			// "it's been ages"
-			if (entry->second.time_spent > c.Age() * 0.25) {
+			if (stay.time_spent > c.Age() * 0.25) {
 				// the place is very familiar
-				c.GetStats().Boredom().Add(-0.2);
+				c.AddStat(Creature::Stats::BOREDOM, -0.2);
 			} else {
 				// infrequent stays
-				c.GetStats().Boredom().Add(-0.1);
+				c.AddStat(Creature::Stats::BOREDOM, -0.1);
 			}
 		}
-		entry->second.last_been = c.GetSimulation().Time();
-		entry->second.last_loc = l;
-		entry->second.time_spent += t;
+		stay.last_been = now;
+		stay.last_loc = l;
+		return;
+	}
+	if (num_types < MAX_TYPES) {
+		slot = num_types++;
 	} else {
-		known_types.emplace(type.id, Stay{
-			c.GetSimulation().Time(),
-			l,
-			c.GetSimulation().Time(),
-			l,
-			t
-		});
-		// completely new place, interesting
-		// TODO: scale by personality trait
-		c.GetStats().Boredom().Add(-0.25);
+		// forget the least important place
+		slot = 0;
+		double least = known_types[0].time_spent * Decay(now - known_types[0].last_been);
+		for (int i = 1; i < num_types; ++i) {
+			const double importance = known_types[i].time_spent * Decay(now - known_types[i].last_been);
+			if (importance < least) {
+				least = importance;
+				slot = i;
+			}
+		}
 	}
+	known_types[slot] = Stay{ cur_type, now, l, now, l, 0.0 };
+	// completely new place, interesting
+	// TODO: scale by personality trait
+	c.AddStat(Creature::Stats::BOREDOM, -0.25);
+}
+
+int Memory::FindType(int type) const noexcept {
+	for (int i = 0; i < num_types; ++i) {
+		if (known_types[i].type == type) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+int Memory::ProfileOf(Creature &other) {
+	const double now = c.GetSimulation().Time();
+	int slot = -1;
+	for (int i = 0; i < num_creatures; ++i) {
+		if (known_creatures[i].other == &other) {
+			slot = i;
+			break;
+		}
+	}
+	if (slot >= 0) {
+		// grudges fade over time
+		Profile &p = known_creatures[slot];
+		const double decay = Decay(now - p.last_seen);
+		p.annoyance *= decay;
+		p.familiarity *= decay;
+		p.last_seen = now;
+		return slot;
+	}
+	if (num_creatures < MAX_CREATURES) {
+		slot = num_creatures++;
+	} else {
+		// forget whoever was seen longest ago
+		slot = 0;
+		for (int i = 1; i < num_creatures; ++i) {
+			if (known_creatures[i].last_seen < known_creatures[slot].last_seen) {
+				slot = i;
+			}
+		}
+	}
+	known_creatures[slot] = Profile{ &other, now, 0.0, 0.0 };
+	return slot;
+}
+
+double Memory::Decay(double since) const noexcept {
+	// memories fade to about a third over a quarter lifetime
+	return std::exp(-since / (c.GetProperties().Lifetime() * 0.25));
 }
 
 
@@ -1011,6 +1282,7 @@ std::string NameGenerator::Sequential() {
 Situation::Situation()
 : planet(nullptr)
 , state(glm::dvec3(0.0), glm::dvec3(0.0))
+, resting(false)
 , type(LOST) {
 }
 
@@ -1044,11 +1316,18 @@ const world::TileType &Situation::GetTileType() const noexcept {
 void Situation::Move(const glm::dvec3 &dp) noexcept {
 	state.pos += dp;
 	EnforceConstraints(state);
+	Wake();
 }
 
 void Situation::Accelerate(const glm::dvec3 &dv) noexcept {
 	state.vel += dv;
 	EnforceConstraints(state);
+	Wake();
+}
+
+void Situation::Rest() noexcept {
+	state.vel = glm::dvec3(0.0);
+	resting = true;
 }
 
 void Situation::EnforceConstraints(State &s) const noexcept {
@@ -1067,6 +1346,7 @@ void Situation::SetPlanetSurface(world::Planet &p, const glm::dvec3 &pos) noexce
 	planet = &p;
 	state.pos = pos;
 	EnforceConstraints(state);
+	Wake();
 }
 
 
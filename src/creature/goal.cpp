@@ -15,10 +15,12 @@
 #include "../world/Resource.hpp"
 #include "../world/Simulation.hpp"
 #include "../world/TileType.hpp"
+#include "../world/TileVicinity.hpp"
 
-#include <cstring>
+#include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <vector>
 #include <glm/gtx/io.hpp>
 #include <glm/gtx/rotate_vector.hpp>
 
@@ -118,7 +120,7 @@ void BlobBackgroundTask::Tick(double dt) {
 		int gas = Assets().data.resources["air"].id;
 		// TODO: check if in compatible atmosphere
 		double amount = GetStats().Breath().gain * -(1.0 + GetCreature().ExhaustionFactor());
-		GetStats().Breath().Add(amount * dt);
+		GetCreature().AddStat(Creature::Stats::BREATH, amount * dt);
 		// maintain ~1% gas composition
 		double gas_amount = GetCreature().GetComposition().Get(gas);
 		if (gas_amount < GetCreature().GetComposition().TotalMass() * 0.01) {
@@ -138,14 +140,14 @@ void BlobBackgroundTask::Action() {
 }
 
 void BlobBackgroundTask::CheckStats() {
-	Creature::Stats &stats = GetStats();
+	const Creature::Stats &stats = GetStats();
 
 	if (!breathing && stats.Breath().Bad()) {
 		breathing = true;
 	}
 
 	if (!drink_subtask && stats.Thirst().Bad()) {
-		drink_subtask = new IngestGoal(GetCreature(), stats.Thirst());
+		drink_subtask = new IngestGoal(GetCreature(), Creature::Stats::THIRST);
 		for (const auto &cmp : GetCreature().GetComposition()) {
 			if (Assets().data.resources[cmp.resource].state == world::Resource::LIQUID) {
 				double value = cmp.value / GetCreature().GetComposition().TotalMass();
@@ -162,7 +164,7 @@ void BlobBackgroundTask::CheckStats() {
 	}
 
 	if (!eat_subtask && stats.Hunger().Bad()) {
-		eat_subtask = new IngestGoal(GetCreature(), stats.Hunger());
+		eat_subtask = new IngestGoal(GetCreature(), Creature::Stats::HUNGER);
 		for (const auto &cmp : GetCreature().GetComposition()) {
 			if (Assets().data.resources[cmp.resource].state == world::Resource::SOLID) {
 				double value = cmp.value / GetCreature().GetComposition().TotalMass();
@@ -224,7 +226,7 @@ const app::Assets &Goal::Assets() const noexcept {
 }
 
 math::GaloisLFSR &Goal::Random() noexcept {
-	return Assets().random;
+	return c.Random();
 }
 
 void Goal::SetComplete() {
@@ -289,7 +291,7 @@ void IdleGoal::Action() {
 	}
 
 	// use boredom as chance per 15s
-	if (Random().UNorm() < GetStats().Boredom().value * (1.0 / 900.0)) {
+	if (Random().UNorm() < GetStats().Boredom().value * (1.0 / 15.0) * GetCreature().TickDelta()) {
 		PickActivity();
 	}
 }
@@ -306,6 +308,9 @@ void IdleGoal::PickActivity() {
 
 namespace {
 
+/// tiles with less of their capacity left are not worth eating from
+constexpr double min_stock = 0.05;
+
 std::string summarize(const Composition &comp, const app::Assets &assets) {
 	std::stringstream s;
 	bool first = true;
@@ -322,15 +327,16 @@ std::string summarize(const Composition &comp, const app::Assets &assets) {
 
 }
 
-IngestGoal::IngestGoal(Creature &c, Creature::Stat &stat)
+IngestGoal::IngestGoal(Creature &c, int s)
 : Goal(c)
-, stat(stat)
+, stat(s)
 , accept(Assets().data.resources)
 , locate_subtask(nullptr)
 , ingesting(false)
+, tile(-1)
 , resource(-1)
 , yield(0.0) {
-	Urgency(stat.value);
+	Urgency(GetStat().value);
 }
 
 IngestGoal::~IngestGoal() {
@@ -357,15 +363,16 @@ void IngestGoal::Enable() {
 }
 
 void IngestGoal::Tick(double dt) {
-	Urgency(stat.value);
+	Urgency(GetStat().value);
 	if (locate_subtask) {
 		locate_subtask->Urgency(Urgency() + 0.1);
 	}
 	if (ingesting) {
 		if (OnSuitableTile() && !GetSituation().Moving()) {
-			GetCreature().Ingest(resource, yield * dt);
-			stat.Add(-1.0 * yield * GetCreature().GetComposition().Compatibility(resource) * dt);
-			if (stat.Empty()) {
+			const double amount = GetSituation().GetPlanet().DepleteTile(tile, yield * dt);
+			GetCreature().Ingest(resource, amount);
+			GetCreature().AddStat(stat, -1.0 * amount * GetCreature().GetComposition().Compatibility(resource));
+			if (GetStat().Empty()) {
 				SetComplete();
 			}
 		} else {
@@ -397,7 +404,7 @@ void IngestGoal::Action() {
 		for (const auto &c : accept) {
 			locate_subtask->Accept(c.resource, c.value);
 		}
-		locate_subtask->SetMinimum(stat.gain * -1.1);
+		locate_subtask->SetMinimum(GetStat().gain * -1.1);
 		locate_subtask->Urgency(Urgency() + 0.1);
 		locate_subtask->WhenComplete([&](Goal &){ locate_subtask = nullptr; });
 		GetCreature().AddGoal(std::unique_ptr<Goal>(locate_subtask));
@@ -408,11 +415,14 @@ bool IngestGoal::OnSuitableTile() {
 	if (!GetSituation().OnGround()) {
 		return false;
 	}
-	const world::TileType &t = GetSituation().GetTileType();
+	const world::Planet &planet = GetSituation().GetPlanet();
+	tile = planet.TileIndexAt(GetSituation().Position());
+	const world::TileType &t = planet.TypeAt(tile);
 	auto found = t.FindBestResource(accept);
-	if (found != t.resources.end()) {
+	const double stock = planet.TileStock(tile);
+	if (found != t.resources.end() && stock > min_stock) {
 		resource = found->resource;
-		yield = found->ubiquity;
+		yield = found->ubiquity * stock;
 		return true;
 	} else {
 		resource = -1;
@@ -478,9 +488,11 @@ void LocateResourceGoal::Action() {
 
 void LocateResourceGoal::LocateResource() {
 	if (GetSituation().OnSurface()) {
-		const world::TileType &t = GetSituation().GetTileType();
+		const world::Planet &planet = GetSituation().GetPlanet();
+		const int here = planet.TileIndexAt(GetSituation().Position());
+		const world::TileType &t = planet.TypeAt(here);
 		auto yield = t.FindBestResource(accept);
-		if (yield != t.resources.cend()) {
+		if (yield != t.resources.cend() && planet.TileStock(here) > min_stock) {
 			// hoooray
 			GetSteering().Halt();
 			found = true;
@@ -506,59 +518,89 @@ void LocateResourceGoal::LocateResource() {
 void LocateResourceGoal::SearchVicinity() {
 	const world::Planet &planet = GetSituation().GetPlanet();
 	const glm::dvec3 &pos = GetSituation().Position();
-	const glm::dvec3 normal(planet.NormalAt(pos));
-	const glm::dvec3 step_x(glm::normalize(glm::cross(normal, glm::dvec3(normal.z, normal.x, normal.y))) * (GetCreature().PerceptionOmniRange() * 0.7));
-	const glm::dvec3 step_y(glm::normalize(glm::cross(step_x, normal)) * (GetCreature().PerceptionOmniRange() * 0.7));
-
-	const int search_radius = int(GetCreature().PerceptionRange() / (GetCreature().PerceptionOmniRange() * 0.7));
-	double rating[2 * search_radius + 1][2 * search_radius + 1];
-	std::memset(rating, '\0', (2 * search_radius + 1) * (2 * search_radius + 1) * sizeof(double));
-
-	// find close and rich field
-	for (int y = -search_radius; y < search_radius + 1; ++y) {
-		for (int x = -search_radius; x < search_radius + 1; ++x) {
-			const glm::dvec3 tpos(pos + (double(x) * step_x) + (double(y) * step_y));
-			if (!GetCreature().PerceptionTest(tpos)) continue;
-			const world::TileType &type = planet.TileTypeAt(tpos);
-			auto yield = type.FindBestResource(accept);
-			if (yield != type.resources.cend()) {
-				rating[y + search_radius][x + search_radius] = yield->ubiquity * accept.Get(yield->resource);
-				// penalize distance
-				double dist = std::max(0.125, 0.25 * glm::length2(tpos - pos));
-				rating[y + search_radius][x + search_radius] /= dist;
+	const int here = planet.TileIndexAt(pos);
+	// tiles are roughly one unit across, anything further is out of sight anyway
+	const int max_steps = int(GetCreature().PerceptionRange()) + 1;
+
+	std::vector<int> candidates;
+	auto consider = [&](int tile) -> bool {
+		if (!GetCreature().PerceptionTest(planet.TileCenter(tile))) return false;
+		const world::TileType &type = planet.TypeAt(tile);
+		if (type.FindBestResource(accept) == type.resources.cend()) return false;
+		if (planet.TileStock(tile) <= min_stock) return false;
+		candidates.push_back(tile);
+		return true;
+	};
+
+	// nearest tile for each accepted resource and its immediate surroundings,
+	// the fields don't know about stock though, so if all of that has been
+	// eaten, widen ring by ring until there's something left
+	for (const auto &c : accept) {
+		if (c.value <= 0.0) continue;
+		const int steps = planet.ResourceDistance(c.resource, here);
+		if (steps < 0 || steps > max_steps) continue;
+		const int nearest = planet.NearestResourceTile(c.resource, here);
+		// no tile in sight is further from the nearest than this
+		const int max_radius = steps + max_steps;
+		bool stocked = false;
+		int ring = 0;
+		for (int radius = 1; !stocked && ring <= max_radius; radius = std::min(radius * 2, max_radius)) {
+			const world::TileVicinity vicinity(planet, nearest, radius);
+			for (; ring <= radius && !(stocked && ring > 1); ++ring) {
+				for (int tile : vicinity.Ring(ring)) {
+					stocked = consider(tile) || stocked;
+				}
+			}
+			if (vicinity.Ring(radius).size() == 0) {
+				// ran out of planet
+				break;
 			}
 		}
 	}
-
-	// penalize crowding
+	if (candidates.empty()) {
+		return;
+	}
+	std::sort(candidates.begin(), candidates.end());
+	candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+	std::vector<glm::dvec3> positions;
+	std::vector<double> ratings;
+	positions.reserve(candidates.size());
+	ratings.reserve(candidates.size());
+	for (int tile : candidates) {
+		const glm::dvec3 tpos(planet.TileCenter(tile));
+		const world::TileType &type = planet.TypeAt(tile);
+		auto yield = type.FindBestResource(accept);
+		double rating = yield->ubiquity * planet.TileStock(tile) * accept.Get(yield->resource);
+		// penalize distance
+		rating /= std::max(0.125, 0.25 * glm::length2(tpos - pos));
+		positions.push_back(tpos);
+		ratings.push_back(rating);
+	}
+	// penalize crowding, candidates are in sight, so creatures
+	// further away than that can't be crowding any of them
+	const double crowd_range = max_steps + 1.0;
 	for (auto &c : planet.Creatures()) {
 		if (&*c == &GetCreature()) continue;
-		for (int y = -search_radius; y < search_radius + 1; ++y) {
-			for (int x = -search_radius; x < search_radius + 1; ++x) {
-				const glm::dvec3 tpos(pos + (double(x) * step_x) + (double(y) * step_y));
-				if (glm::length2(tpos - c->GetSituation().Position()) < 1.0) {
-					rating[y + search_radius][x + search_radius] *= 0.8;
-				}
+		const glm::dvec3 &cpos = c->GetSituation().Position();
+		if (glm::length2(cpos - pos) > crowd_range * crowd_range) continue;
+		for (std::size_t i = 0; i < candidates.size(); ++i) {
+			if (glm::length2(positions[i] - cpos) < 1.0) {
+				ratings[i] *= 0.8;
 			}
 		}
 	}
 
-	glm::ivec2 best_pos(0);
-	double best_rating = -1.0;
-
-	for (int y = -search_radius; y < search_radius + 1; ++y) {
-		for (int x = -search_radius; x < search_radius + 1; ++x) {
-			if (rating[y + search_radius][x + search_radius] > best_rating) {
-				best_pos = glm::ivec2(x, y);
-				best_rating = rating[y + search_radius][x + search_radius];
-			}
+	std::size_t best = 0;
+	for (std::size_t i = 1; i < candidates.size(); ++i) {
+		if (ratings[i] > ratings[best]) {
+			best = i;
 		}
 	}
-
-	if (best_rating > minimum) {
+	if (ratings[best] > minimum) {
 		found = true;
 		searching = false;
-		target_pos = glm::normalize(pos + (double(best_pos.x) * step_x) + (double(best_pos.y) * step_y)) * planet.Radius();
+		target_pos = positions[best];
 		GetSteering().GoTo(target_pos);
 	}
 }
@@ -0,0 +1,46 @@
+#ifndef BLOBS_GRAPHICS_BUFFERTEXTURE_HPP_
+#define BLOBS_GRAPHICS_BUFFERTEXTURE_HPP_
+
+#include "TextureBase.hpp"
+
+#include <GL/glew.h>
+
+
+namespace blobs {
+namespace graphics {
+
+/// Texture backed by a buffer object, for reading raw data in shaders
+/// with texelFetch.
+class BufferTexture
+: public TextureBase<GL_TEXTURE_BUFFER> {
+
+public:
+	BufferTexture();
+	~BufferTexture();
+
+	BufferTexture(BufferTexture &&) noexcept;
+	BufferTexture &operator =(BufferTexture &&) noexcept;
+
+	BufferTexture(const BufferTexture &) = delete;
+	BufferTexture &operator =(const BufferTexture &) = delete;
+
+public:
+	/// size of the buffer in bytes
+	GLsizeiptr Size() const noexcept { return size; }
+
+	/// allocate given number of bytes, interpreted as texels of given
+	/// internal format (e.g. GL_R16UI)
+	void Reserve(GLsizeiptr size, GLenum internal, GLenum usage) noexcept;
+	/// replace size bytes starting at offset
+	void Data(GLintptr offset, GLsizeiptr size, const GLvoid *data) noexcept;
+
+private:
+	GLuint buffer;
+	GLsizeiptr size;
+
+};
+
+}
+}
+
+#endif
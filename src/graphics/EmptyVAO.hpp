@@ -0,0 +1,46 @@
+#ifndef BLOBS_GRAPHICS_EMPTYVAO_HPP_
+#define BLOBS_GRAPHICS_EMPTYVAO_HPP_
+
+#include <cstddef>
+#include <GL/glew.h>
+
+
+namespace blobs {
+namespace graphics {
+
+/// Vertex array object without any attributes, for draw calls whose
+/// vertices are generated in the shader from gl_VertexID.
+class EmptyVAO {
+
+public:
+	EmptyVAO()
+	: vao(0) {
+		glGenVertexArrays(1, &vao);
+	}
+	~EmptyVAO() noexcept {
+		glDeleteVertexArrays(1, &vao);
+	}
+
+	EmptyVAO(const EmptyVAO &) = delete;
+	EmptyVAO &operator =(const EmptyVAO &) = delete;
+
+public:
+	void Bind() const noexcept {
+		glBindVertexArray(vao);
+	}
+	void Unbind() const noexcept {
+		glBindVertexArray(0);
+	}
+	void DrawTriangles(std::size_t count, std::size_t first = 0) const noexcept {
+		glDrawArrays(GL_TRIANGLES, first, count);
+	}
+
+private:
+	GLuint vao;
+
+};
+
+}
+}
+
+#endif
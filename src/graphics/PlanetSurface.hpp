@@ -8,11 +8,13 @@ namespace blobs {
 namespace graphics {
 
 class ArrayTexture;
+class BufferTexture;
 
 class PlanetSurface {
 
 public:
 	static constexpr int MAX_LIGHTS = 8;
+	static constexpr int MAX_TILE_TYPES = 32;
 
 public:
 	PlanetSurface();
@@ -36,6 +38,15 @@ public:
 	void SetLight(int n, const glm::vec3 &pos, const glm::vec3 &color, float strength) noexcept;
 	void SetNumLights(int n) noexcept;
 
+	/// texture layer and material of the tile type with given ID
+	void SetTileType(int id, float texture, float shiny, float glossy, float metallic) noexcept;
+	/// per tile type IDs, as 16 bit unsigned integers
+	void SetTiles(BufferTexture &) noexcept;
+	void SetPlanet(float radius, int sidelength) noexcept;
+	/// the chunk of tiles to draw, starting at x,y on given surface
+	/// with each quad covering step² tiles and columns quads per row
+	void SetChunk(int surface, int x, int y, int step, int columns) noexcept;
+
 	const glm::mat4 &M() const noexcept { return m; }
 	const glm::mat4 &V() const noexcept { return v; }
 	const glm::mat4 &P() const noexcept { return p; }
@@ -62,6 +73,12 @@ private:
 	GLuint num_lights_handle;
 	GLuint light_handle[MAX_LIGHTS * 3];
 
+	GLuint tiles_handle;
+	GLuint tile_type_handle[MAX_TILE_TYPES];
+	GLuint radius_handle;
+	GLuint sidelength_handle;
+	GLuint chunk_handle[5];
+
 };
 
 }
@@ -1,4 +1,5 @@
 #include "ArrayTexture.hpp"
+#include "BufferTexture.hpp"
 #include "CubeMap.hpp"
 #include "Font.hpp"
 #include "Format.hpp"
@@ -425,6 +426,47 @@ void ArrayTexture::Data(GLsizei l, const Format &f, GLvoid *data) noexcept {
 }
 
 
+BufferTexture::BufferTexture()
+: TextureBase()
+, buffer(0)
+, size(0) {
+	glGenBuffers(1, &buffer);
+}
+
+BufferTexture::~BufferTexture() {
+	glDeleteBuffers(1, &buffer);
+}
+
+BufferTexture::BufferTexture(BufferTexture &&other) noexcept
+: TextureBase(std::move(other)) {
+	buffer = other.buffer;
+	size = other.size;
+	other.buffer = 0;
+	other.size = 0;
+}
+
+BufferTexture &BufferTexture::operator =(BufferTexture &&other) noexcept {
+	TextureBase::operator =(std::move(other));
+	std::swap(buffer, other.buffer);
+	std::swap(size, other.size);
+	return *this;
+}
+
+
+void BufferTexture::Reserve(GLsizeiptr s, GLenum internal, GLenum usage) noexcept {
+	glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+	glBufferData(GL_TEXTURE_BUFFER, s, nullptr, usage);
+	Bind();
+	glTexBuffer(GL_TEXTURE_BUFFER, internal, buffer);
+	size = s;
+}
+
+void BufferTexture::Data(GLintptr offset, GLsizeiptr s, const GLvoid *data) noexcept {
+	glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+	glBufferSubData(GL_TEXTURE_BUFFER, offset, s, data);
+}
+
+
 CubeMap::CubeMap()
 : TextureBase() {
 
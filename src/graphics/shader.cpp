@@ -8,6 +8,7 @@
 #include "SunSurface.hpp"
 
 #include "ArrayTexture.hpp"
+#include "BufferTexture.hpp"
 #include "CubeMap.hpp"
 #include "Texture.hpp"
 #include "../app/init.hpp"
@@ -184,24 +185,33 @@ void Program::Uniform(GLint loc, const glm::mat4 &val) noexcept {
 
 
 constexpr int PlanetSurface::MAX_LIGHTS;
+constexpr int PlanetSurface::MAX_TILE_TYPES;
 
 PlanetSurface::PlanetSurface()
 : prog() {
 	prog.LoadShader(
 		GL_VERTEX_SHADER,
+		(std::string(
 		"#version 330 core\n"
 
-		"layout(location = 0) in vec3 vtx_position;\n"
-		"layout(location = 1) in vec3 vtx_normal;\n"
-		"layout(location = 2) in vec3 vtx_tex_uv;\n"
-		"layout(location = 3) in float vtx_shiny;\n"
-		"layout(location = 4) in float vtx_glossy;\n"
-		"layout(location = 5) in float vtx_metallic;\n"
-
 		"uniform mat4 M;\n"
 		"uniform mat4 MV;\n"
 		"uniform mat4 MVP;\n"
 
+		"uniform float radius;\n"
+		"uniform int sidelength;\n"
+		"uniform int chunk_surface;\n"
+		"uniform int chunk_x;\n"
+		"uniform int chunk_y;\n"
+		"uniform int chunk_step;\n"
+		"uniform int chunk_columns;\n"
+		"uniform usamplerBuffer tiles;\n"
+		// texture layer, shiny, glossy, metallic
+		"uniform vec4 tile_types[") + std::to_string(MAX_TILE_TYPES) + "];\n"
+
+		// corners of a quad's two triangles, winding flips for surfaces 3-5
+		"const int corners[12] = int[12](0, 2, 1, 1, 2, 3, 0, 1, 2, 2, 1, 3);\n"
+
 		"out vec3 vtx_viewspace;\n"
 		"out vec3 nrm_viewspace;\n"
 		"out vec3 frag_tex_uv;\n"
@@ -210,14 +220,35 @@ PlanetSurface::PlanetSurface()
 		"out float frag_metallic;\n"
 
 		"void main() {\n"
+			"int quad = gl_VertexID / 6;\n"
+			"int corner = corners[(chunk_surface < 3 ? 0 : 6) + gl_VertexID % 6];\n"
+			"int x0 = chunk_x + (quad % chunk_columns) * chunk_step;\n"
+			"int y0 = chunk_y + (quad / chunk_columns) * chunk_step;\n"
+			"int x1 = min(x0 + chunk_step, sidelength);\n"
+			"int y1 = min(y0 + chunk_step, sidelength);\n"
+			// coarser quads show the tile at their middle
+			"int tile = (chunk_surface * sidelength + (y0 + y1) / 2) * sidelength + (x0 + x1) / 2;\n"
+			"vec4 material = tile_types[texelFetch(tiles, tile).r];\n"
+			"vec3 cube;\n"
+			"cube[chunk_surface % 3] = float(corner < 2 ? x0 : x1) - radius;\n"
+			"cube[(chunk_surface + 1) % 3] = float(corner % 2 == 0 ? y0 : y1) - radius;\n"
+			"cube[(chunk_surface + 2) % 3] = radius;\n"
+			"vec3 vtx_position = normalize(cube) * (chunk_surface < 3 ? radius : -radius);\n"
 			"gl_Position = MVP * vec4(vtx_position, 1.0);\n"
 			"vtx_viewspace = (MV * vec4(vtx_position, 1.0)).xyz;\n"
+			// a sphere's normal is its position, this is what the shader
+			// always used, the unnormalized cube vector that was uploaded
+			// as vtx_normal never made it into the lighting
 			"nrm_viewspace = (MV * vec4(vtx_position, 0.0)).xyz;\n"
-			"frag_tex_uv = vtx_tex_uv;\n"
-			"frag_shiny = vtx_shiny;\n"
-			"frag_glossy = vtx_glossy;\n"
-			"frag_metallic = vtx_metallic;\n"
+			"frag_tex_uv = vec3("
+				"corner < 2 ? 0.0 : 1.0, "
+				"((corner % 2 == 0) == (chunk_surface < 3)) ? 1.0 : 0.0, "
+				"material.x);\n"
+			"frag_shiny = material.y;\n"
+			"frag_glossy = material.z;\n"
+			"frag_metallic = material.w;\n"
 		"}\n"
+		).c_str()
 	);
 	prog.LoadShader(
 		GL_FRAGMENT_SHADER,
@@ -279,6 +310,17 @@ PlanetSurface::PlanetSurface()
 		light_handle[3 * i + 1]  = prog.UniformLocation("light[" + std::to_string(i) + "].color");
 		light_handle[3 * i + 2]  = prog.UniformLocation("light[" + std::to_string(i) + "].strength");
 	}
+	tiles_handle = prog.UniformLocation("tiles");
+	for (int i = 0; i < MAX_TILE_TYPES; ++i) {
+		tile_type_handle[i] = prog.UniformLocation("tile_types[" + std::to_string(i) + "]");
+	}
+	radius_handle = prog.UniformLocation("radius");
+	sidelength_handle = prog.UniformLocation("sidelength");
+	chunk_handle[0] = prog.UniformLocation("chunk_surface");
+	chunk_handle[1] = prog.UniformLocation("chunk_x");
+	chunk_handle[2] = prog.UniformLocation("chunk_y");
+	chunk_handle[3] = prog.UniformLocation("chunk_step");
+	chunk_handle[4] = prog.UniformLocation("chunk_columns");
 }
 
 PlanetSurface::~PlanetSurface() {
@@ -349,6 +391,31 @@ void PlanetSurface::SetNumLights(int n) noexcept {
 	prog.Uniform(num_lights_handle, std::min(MAX_LIGHTS, n));
 }
 
+void PlanetSurface::SetTileType(int id, float texture, float shiny, float glossy, float metallic) noexcept {
+	prog.Uniform(tile_type_handle[id], glm::vec4(texture, shiny, glossy, metallic));
+}
+
+void PlanetSurface::SetTiles(BufferTexture &tex) noexcept {
+	glActiveTexture(GL_TEXTURE1);
+	tex.Bind();
+	prog.Uniform(tiles_handle, GLint(1));
+	// others expect unit 0 to be active
+	glActiveTexture(GL_TEXTURE0);
+}
+
+void PlanetSurface::SetPlanet(float radius, int sidelength) noexcept {
+	prog.Uniform(radius_handle, radius);
+	prog.Uniform(sidelength_handle, GLint(sidelength));
+}
+
+void PlanetSurface::SetChunk(int surface, int x, int y, int step, int columns) noexcept {
+	prog.Uniform(chunk_handle[0], GLint(surface));
+	prog.Uniform(chunk_handle[1], GLint(x));
+	prog.Uniform(chunk_handle[2], GLint(y));
+	prog.Uniform(chunk_handle[3], GLint(step));
+	prog.Uniform(chunk_handle[4], GLint(columns));
+}
+
 
 SkyBox::SkyBox()
 : prog()
@@ -38,8 +38,8 @@ public:
 		constexpr int num_bits =
 			std::numeric_limits<T>::digits +
 			std::numeric_limits<T>::is_signed;
-		for (int i = 0; i < num_bits; ++i) {
-			operator ()();
+		for (int left = num_bits; left > 0; left -= 32) {
+			Step(left < 32 ? left : 32);
 		}
 		return out = static_cast<T>(state);
 	}
@@ -78,6 +78,28 @@ public:
 		return c[Next<typename Container::size_type>() % c.size()];
 	}
 
+	/// advance as if n bits had been drawn
+	void Jump(std::uint64_t n) noexcept;
+
+	/// get a generator for given substream, which starts 2^40 bits
+	/// after the previous one, stream 0 is a copy of this one
+	GaloisLFSR Split(std::uint64_t stream) const noexcept {
+		GaloisLFSR result(*this);
+		result.Jump(stream << 40);
+		return result;
+	}
+
+private:
+	/// advance by n bits at once, n must be in [1,32]
+	void Step(int n) noexcept {
+		// the lowest n bits are shifted out one after the other and,
+		// if set, fed back at bits 62, 60, and 59. since feedback
+		// takes at least 59 steps to arrive at bit 0, it can be
+		// applied for all of them in one go
+		const std::uint64_t low = state & ((std::uint64_t(1) << n) - 1);
+		state = (state >> n) ^ (low << (63 - n)) ^ (low << (61 - n)) ^ (low << (60 - n));
+	}
+
 private:
 	std::uint64_t state;
 	// bits 64, 63, 61, and 60 set to 1 (counting from 1 lo to hi)
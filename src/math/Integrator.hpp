@@ -0,0 +1,52 @@
+#ifndef BLOBS_MATH_INTEGRATOR_HPP_
+#define BLOBS_MATH_INTEGRATOR_HPP_
+
+
+namespace blobs {
+namespace math {
+
+/// numerical integration schemes, from cheapest to most accurate
+enum Integrator {
+	/// semi-implicit euler, one evaluation
+	EULER,
+	/// velocity verlet, two evaluations
+	VERLET,
+	/// classic runge-kutta, four evaluations
+	RK4,
+};
+
+/// Integrate over one step of length dt.
+/// Derivative must have vel and acc members and a (vel, acc) constructor.
+/// eval(ds, t) must return the derivative of the initial state
+/// advanced by ds over time t.
+/// Returns the average derivative for the step, so that pos += vel * dt
+/// and vel += acc * dt yield the integrated state.
+template<class Derivative, class Eval>
+Derivative Integrate(Integrator method, Eval eval, double dt) {
+	const Derivative a(eval(Derivative(), 0.0));
+	switch (method) {
+		case EULER:
+			// update velocity first, then position using the new velocity
+			return Derivative(a.vel + a.acc * dt, a.acc);
+		case VERLET: {
+			const Derivative ds(a.vel + a.acc * (dt * 0.5), a.acc);
+			const Derivative b(eval(ds, dt));
+			return Derivative(ds.vel, (a.acc + b.acc) * 0.5);
+		}
+		default:
+		case RK4: {
+			const Derivative b(eval(a, dt * 0.5));
+			const Derivative c(eval(b, dt * 0.5));
+			const Derivative d(eval(c, dt));
+			return Derivative(
+				(1.0 / 6.0) * (a.vel + 2.0 * (b.vel + c.vel) + d.vel),
+				(1.0 / 6.0) * (a.acc + 2.0 * (b.acc + c.acc) + d.acc)
+			);
+		}
+	}
+}
+
+}
+}
+
+#endif
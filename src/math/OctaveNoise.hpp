@@ -29,6 +29,85 @@ float OctaveNoise(
 	return total / max;
 }
 
+/// same as above, but with number of octaves and growth fixed at
+/// compile time
+template<int Octaves, int Growth = 2, class Noise>
+float OctaveNoise(
+	const Noise &noise,
+	const glm::vec3 &in,
+	float persistence,
+	float frequency = 1.0f,
+	float amplitude = 1.0f
+) {
+	static_assert(Octaves > 0, "need at least one octave");
+	float total = 0.0f;
+	float max = 0.0f;
+	for (int i = 0; i < Octaves; ++i) {
+		total += noise(in * frequency) * amplitude;
+		max += amplitude;
+		amplitude *= persistence;
+		frequency *= float(Growth);
+	}
+	return total / max;
+}
+
+/// evaluate the above for count points given as separate coordinate
+/// arrays, noise must support batches the way SimplexNoise does
+/// all octaves are done for a block of points before moving on to the
+/// next block, results are the same as evaluating them one by one
+template<int Octaves, int Growth = 2, class Noise>
+void OctaveNoise(
+	const Noise &noise,
+	const float *x,
+	const float *y,
+	const float *z,
+	float *out,
+	int count,
+	float persistence,
+	float frequency = 1.0f,
+	float amplitude = 1.0f
+) {
+	static_assert(Octaves > 0, "need at least one octave");
+	constexpr int block = 64;
+	float scaled_x[block];
+	float scaled_y[block];
+	float scaled_z[block];
+	float octave[block];
+
+	float amplitudes[Octaves];
+	float frequencies[Octaves];
+	float max = 0.0f;
+	for (int i = 0; i < Octaves; ++i) {
+		amplitudes[i] = amplitude;
+		frequencies[i] = frequency;
+		max += amplitude;
+		amplitude *= persistence;
+		frequency *= float(Growth);
+	}
+
+	for (int start = 0; start < count; start += block) {
+		const int n = count - start < block ? count - start : block;
+		float *total = out + start;
+		for (int j = 0; j < n; ++j) {
+			total[j] = 0.0f;
+		}
+		for (int i = 0; i < Octaves; ++i) {
+			for (int j = 0; j < n; ++j) {
+				scaled_x[j] = x[start + j] * frequencies[i];
+				scaled_y[j] = y[start + j] * frequencies[i];
+				scaled_z[j] = z[start + j] * frequencies[i];
+			}
+			noise(scaled_x, scaled_y, scaled_z, octave, n);
+			for (int j = 0; j < n; ++j) {
+				total[j] += octave[j] * amplitudes[i];
+			}
+		}
+		for (int j = 0; j < n; ++j) {
+			total[j] /= max;
+		}
+	}
+}
+
 }
 }
 
@@ -15,6 +15,9 @@ public:
 	explicit SimplexNoise(std::uint64_t seed) noexcept;
 
 	float operator ()(const glm::vec3 &) const noexcept;
+	/// evaluate count points given as separate coordinate arrays into out
+	/// gives the same results as evaluating them one by one
+	void operator ()(const float *x, const float *y, const float *z, float *out, int count) const noexcept;
 
 private:
 	int Perm(int idx) const noexcept;
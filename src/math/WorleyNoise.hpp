@@ -14,10 +14,19 @@ public:
 	explicit WorleyNoise(unsigned int seed) noexcept;
 
 	float operator ()(const glm::vec3 &) const noexcept;
+	/// distances to the closest (F1) and second closest (F2) feature
+	/// point for count points given as separate coordinate arrays
+	/// both are capped at 1, f2 may be null if not needed
+	void operator ()(const float *x, const float *y, const float *z, float *f1, float *f2, int count) const noexcept;
+
+private:
+	static constexpr int num_points = 8;
+
+	/// generate the feature points of the unit cube at given corner
+	void Points(const glm::vec3 &cube, glm::vec3 *points) const noexcept;
 
 private:
 	const unsigned int seed;
-	const int num_points;
 
 };
 
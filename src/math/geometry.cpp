@@ -1,9 +1,45 @@
 #include "geometry.hpp"
 
+#include <cmath>
+#include <limits>
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 
 namespace blobs {
 namespace math {
 
+namespace {
+
+/// box projected onto an axis
+struct Interval {
+	double min;
+	double max;
+};
+
+/// oriented box in terms of center, axes, and half extents
+struct OBB {
+	glm::dvec3 center;
+	glm::dvec3 axes[3];
+	glm::dvec3 half;
+	OBB(const AABB &box, const glm::dmat4 &m) noexcept
+	: center(m * glm::dvec4(box.Center(), 1.0))
+	, axes{ glm::dvec3(m[0]), glm::dvec3(m[1]), glm::dvec3(m[2]) }
+	, half((box.max - box.min) * 0.5) {
+	}
+	Interval Project(const glm::dvec3 &axis) const noexcept {
+		const double c = glm::dot(center, axis);
+		const double r =
+			std::abs(glm::dot(axes[0], axis)) * half.x +
+			std::abs(glm::dot(axes[1], axis)) * half.y +
+			std::abs(glm::dot(axes[2], axis)) * half.z;
+		return { c - r, c + r };
+	}
+};
+
+}
+
 bool Intersect(
 	const AABB &a_box,
 	const glm::dmat4 &a_m,
@@ -12,44 +48,45 @@ bool Intersect(
 	glm::dvec3 &normal,
 	double &depth
 ) noexcept {
-	glm::dvec3 a_corners[8] = {
-		glm::dvec3(a_m * glm::dvec4(a_box.min.x, a_box.min.y, a_box.min.z, 1.0)),
-		glm::dvec3(a_m * glm::dvec4(a_box.min.x, a_box.min.y, a_box.max.z, 1.0)),
-		glm::dvec3(a_m * glm::dvec4(a_box.min.x, a_box.max.y, a_box.min.z, 1.0)),
-		glm::dvec3(a_m * glm::dvec4(a_box.min.x, a_box.max.y, a_box.max.z, 1.0)),
-		glm::dvec3(a_m * glm::dvec4(a_box.max.x, a_box.min.y, a_box.min.z, 1.0)),
-		glm::dvec3(a_m * glm::dvec4(a_box.max.x, a_box.min.y, a_box.max.z, 1.0)),
-		glm::dvec3(a_m * glm::dvec4(a_box.max.x, a_box.max.y, a_box.min.z, 1.0)),
-		glm::dvec3(a_m * glm::dvec4(a_box.max.x, a_box.max.y, a_box.max.z, 1.0)),
-	};
+	glm::dvec3 axis(0.0);
+	return Intersect(a_box, a_m, b_box, b_m, normal, depth, axis);
+}
 
-	glm::dvec3 b_corners[8] = {
-		glm::dvec3(b_m * glm::dvec4(b_box.min.x, b_box.min.y, b_box.min.z, 1.0)),
-		glm::dvec3(b_m * glm::dvec4(b_box.min.x, b_box.min.y, b_box.max.z, 1.0)),
-		glm::dvec3(b_m * glm::dvec4(b_box.min.x, b_box.max.y, b_box.min.z, 1.0)),
-		glm::dvec3(b_m * glm::dvec4(b_box.min.x, b_box.max.y, b_box.max.z, 1.0)),
-		glm::dvec3(b_m * glm::dvec4(b_box.max.x, b_box.min.y, b_box.min.z, 1.0)),
-		glm::dvec3(b_m * glm::dvec4(b_box.max.x, b_box.min.y, b_box.max.z, 1.0)),
-		glm::dvec3(b_m * glm::dvec4(b_box.max.x, b_box.max.y, b_box.min.z, 1.0)),
-		glm::dvec3(b_m * glm::dvec4(b_box.max.x, b_box.max.y, b_box.max.z, 1.0)),
-	};
+bool Intersect(
+	const AABB &a_box,
+	const glm::dmat4 &a_m,
+	const AABB &b_box,
+	const glm::dmat4 &b_m,
+	glm::dvec3 &normal,
+	double &depth,
+	glm::dvec3 &hint
+) noexcept {
+	const OBB a(a_box, a_m);
+	const OBB b(b_box, b_m);
+
+	if (!allzero(hint)) {
+		// boxes that were apart usually still are along the same axis
+		const Interval a_int(a.Project(hint));
+		const Interval b_int(b.Project(hint));
+		if (a_int.max < b_int.min || b_int.max < a_int.min) return false;
+	}
 
 	glm::dvec3 axes[15] = {
-		glm::dvec3(a_m[0]),
-		glm::dvec3(a_m[1]),
-		glm::dvec3(a_m[2]),
-		glm::dvec3(b_m[0]),
-		glm::dvec3(b_m[1]),
-		glm::dvec3(b_m[2]),
-		glm::normalize(glm::cross(glm::dvec3(a_m[0]), glm::dvec3(b_m[0]))),
-		glm::normalize(glm::cross(glm::dvec3(a_m[0]), glm::dvec3(b_m[1]))),
-		glm::normalize(glm::cross(glm::dvec3(a_m[0]), glm::dvec3(b_m[2]))),
-		glm::normalize(glm::cross(glm::dvec3(a_m[1]), glm::dvec3(b_m[0]))),
-		glm::normalize(glm::cross(glm::dvec3(a_m[1]), glm::dvec3(b_m[1]))),
-		glm::normalize(glm::cross(glm::dvec3(a_m[1]), glm::dvec3(b_m[2]))),
-		glm::normalize(glm::cross(glm::dvec3(a_m[2]), glm::dvec3(b_m[0]))),
-		glm::normalize(glm::cross(glm::dvec3(a_m[2]), glm::dvec3(b_m[1]))),
-		glm::normalize(glm::cross(glm::dvec3(a_m[2]), glm::dvec3(b_m[2]))),
+		a.axes[0],
+		a.axes[1],
+		a.axes[2],
+		b.axes[0],
+		b.axes[1],
+		b.axes[2],
+		glm::normalize(glm::cross(a.axes[0], b.axes[0])),
+		glm::normalize(glm::cross(a.axes[0], b.axes[1])),
+		glm::normalize(glm::cross(a.axes[0], b.axes[2])),
+		glm::normalize(glm::cross(a.axes[1], b.axes[0])),
+		glm::normalize(glm::cross(a.axes[1], b.axes[1])),
+		glm::normalize(glm::cross(a.axes[1], b.axes[2])),
+		glm::normalize(glm::cross(a.axes[2], b.axes[0])),
+		glm::normalize(glm::cross(a.axes[2], b.axes[1])),
+		glm::normalize(glm::cross(a.axes[2], b.axes[2])),
 	};
 
 	depth = std::numeric_limits<double>::infinity();
@@ -62,25 +99,15 @@ bool Intersect(
 			++cur_axis;
 			continue;
 		}
-		double a_min = std::numeric_limits<double>::infinity();
-		double a_max = -std::numeric_limits<double>::infinity();
-		for (const glm::dvec3 &corner : a_corners) {
-			double val = glm::dot(corner, axis);
-			a_min = std::min(a_min, val);
-			a_max = std::max(a_max, val);
-		}
+		const Interval a_int(a.Project(axis));
+		const Interval b_int(b.Project(axis));
 
-		double b_min = std::numeric_limits<double>::infinity();
-		double b_max = -std::numeric_limits<double>::infinity();
-		for (const glm::dvec3 &corner : b_corners) {
-			double val = glm::dot(corner, axis);
-			b_min = std::min(b_min, val);
-			b_max = std::max(b_max, val);
+		if (a_int.max < b_int.min || b_int.max < a_int.min) {
+			hint = axis;
+			return false;
 		}
 
-		if (a_max < b_min || b_max < a_min) return false;
-
-		double overlap = std::min(a_max, b_max) - std::max(a_min, b_min);
+		double overlap = std::min(a_int.max, b_int.max) - std::max(a_int.min, b_int.min);
 		if (overlap < depth) {
 			depth = overlap;
 			min_axis = cur_axis;
@@ -90,10 +117,220 @@ bool Intersect(
 	}
 
 	normal = axes[min_axis];
+	hint = normal;
 	return true;
 }
 
 
+namespace {
+
+/// tolerance of the packet test relative to the sum of both projected
+/// radii, orders of magnitude above the error of float dot products
+constexpr float packet_tolerance = 1.0e-4f;
+/// lower bound for the tolerance, for really flat boxes
+constexpr float packet_min_tolerance = 1.0e-6f;
+
+}
+
+void OBBPacket::Set(int lane, const AABB &box, const glm::dmat4 &m) noexcept {
+	const glm::dvec3 c(glm::dvec3(m * glm::dvec4(box.Center(), 1.0)) - origin);
+	const glm::dvec3 h((box.max - box.min) * 0.5);
+	for (int i = 0; i < 3; ++i) {
+		center[i][lane] = float(c[i]);
+		half[i][lane] = float(h[i]);
+		for (int j = 0; j < 3; ++j) {
+			axes[i][j][lane] = float(m[i][j]);
+		}
+	}
+}
+
+#ifdef __SSE2__
+
+namespace {
+
+inline __m128 dot(const __m128 a[3], __m128 x, __m128 y, __m128 z) noexcept {
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[0], x), _mm_mul_ps(a[1], y)), _mm_mul_ps(a[2], z));
+}
+
+inline __m128 abs(__m128 x) noexcept {
+	return _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+}
+
+inline __m128 select(__m128 mask, __m128 a, __m128 b) noexcept {
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+}
+
+int Intersect(
+	const AABB &a_box,
+	const glm::dmat4 &a_m,
+	const OBBPacket &b,
+	glm::vec3 *normal,
+	float *depth
+) noexcept {
+	const glm::dvec3 a_c(glm::dvec3(a_m * glm::dvec4(a_box.Center(), 1.0)) - b.origin);
+	const glm::dvec3 a_h((a_box.max - a_box.min) * 0.5);
+
+	__m128 ac[3], ah[3], aa[3][3];
+	__m128 bc[3], bh[3], ba[3][3];
+	for (int i = 0; i < 3; ++i) {
+		ac[i] = _mm_set1_ps(float(a_c[i]));
+		ah[i] = _mm_set1_ps(float(a_h[i]));
+		bc[i] = _mm_loadu_ps(b.center[i]);
+		bh[i] = _mm_loadu_ps(b.half[i]);
+		for (int j = 0; j < 3; ++j) {
+			aa[i][j] = _mm_set1_ps(float(a_m[i][j]));
+			ba[i][j] = _mm_loadu_ps(b.axes[i][j]);
+		}
+	}
+
+	const __m128 all = _mm_castsi128_ps(_mm_set1_epi32(-1));
+	__m128 separated = _mm_setzero_ps();
+	__m128 min_depth = _mm_set1_ps(std::numeric_limits<float>::infinity());
+	__m128 nx = _mm_setzero_ps();
+	__m128 ny = _mm_setzero_ps();
+	__m128 nz = _mm_setzero_ps();
+
+	auto test = [&](__m128 x, __m128 y, __m128 z, __m128 valid) {
+		const __m128 a_proj = dot(ac, x, y, z);
+		const __m128 a_rad = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(abs(dot(aa[0], x, y, z)), ah[0]),
+			_mm_mul_ps(abs(dot(aa[1], x, y, z)), ah[1])),
+			_mm_mul_ps(abs(dot(aa[2], x, y, z)), ah[2]));
+		const __m128 b_proj = dot(bc, x, y, z);
+		const __m128 b_rad = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(abs(dot(ba[0], x, y, z)), bh[0]),
+			_mm_mul_ps(abs(dot(ba[1], x, y, z)), bh[1])),
+			_mm_mul_ps(abs(dot(ba[2], x, y, z)), bh[2]));
+		const __m128 a_min = _mm_sub_ps(a_proj, a_rad);
+		const __m128 a_max = _mm_add_ps(a_proj, a_rad);
+		const __m128 b_min = _mm_sub_ps(b_proj, b_rad);
+		const __m128 b_max = _mm_add_ps(b_proj, b_rad);
+		const __m128 tol = _mm_max_ps(
+			_mm_mul_ps(_mm_add_ps(a_rad, b_rad), _mm_set1_ps(packet_tolerance)),
+			_mm_set1_ps(packet_min_tolerance));
+		separated = _mm_or_ps(separated, _mm_and_ps(valid, _mm_or_ps(
+			_mm_cmplt_ps(_mm_add_ps(a_max, tol), b_min),
+			_mm_cmplt_ps(_mm_add_ps(b_max, tol), a_min))));
+		const __m128 overlap = _mm_sub_ps(_mm_min_ps(a_max, b_max), _mm_max_ps(a_min, b_min));
+		const __m128 closer = _mm_and_ps(valid, _mm_cmplt_ps(overlap, min_depth));
+		min_depth = select(closer, overlap, min_depth);
+		nx = select(closer, x, nx);
+		ny = select(closer, y, ny);
+		nz = select(closer, z, nz);
+	};
+
+	for (int i = 0; i < 3; ++i) {
+		test(aa[i][0], aa[i][1], aa[i][2], all);
+	}
+	for (int i = 0; i < 3; ++i) {
+		test(ba[i][0], ba[i][1], ba[i][2], all);
+	}
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			__m128 x = _mm_sub_ps(_mm_mul_ps(aa[i][1], ba[j][2]), _mm_mul_ps(aa[i][2], ba[j][1]));
+			__m128 y = _mm_sub_ps(_mm_mul_ps(aa[i][2], ba[j][0]), _mm_mul_ps(aa[i][0], ba[j][2]));
+			__m128 z = _mm_sub_ps(_mm_mul_ps(aa[i][0], ba[j][1]), _mm_mul_ps(aa[i][1], ba[j][0]));
+			const __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+			// skip axes from parallel edges
+			const __m128 valid = _mm_cmpgt_ps(len2, _mm_set1_ps(1.0e-12f));
+			const __m128 inv_len = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_max_ps(len2, _mm_set1_ps(1.0e-12f))));
+			x = _mm_mul_ps(x, inv_len);
+			y = _mm_mul_ps(y, inv_len);
+			z = _mm_mul_ps(z, inv_len);
+			test(x, y, z, valid);
+		}
+	}
+
+	const int mask = ~_mm_movemask_ps(separated) & ((1 << b.count) - 1);
+	if (normal) {
+		float x[4], y[4], z[4];
+		_mm_storeu_ps(x, nx);
+		_mm_storeu_ps(y, ny);
+		_mm_storeu_ps(z, nz);
+		for (int i = 0; i < b.count; ++i) {
+			normal[i] = glm::vec3(x[i], y[i], z[i]);
+		}
+	}
+	if (depth) {
+		_mm_storeu_ps(depth, min_depth);
+	}
+	return mask;
+}
+
+#else
+
+int Intersect(
+	const AABB &a_box,
+	const glm::dmat4 &a_m,
+	const OBBPacket &b,
+	glm::vec3 *normal,
+	float *depth
+) noexcept {
+	const glm::vec3 a_c(glm::dvec3(a_m * glm::dvec4(a_box.Center(), 1.0)) - b.origin);
+	const glm::vec3 a_h((a_box.max - a_box.min) * 0.5);
+	const glm::vec3 a_axes[3] = { glm::vec3(a_m[0]), glm::vec3(a_m[1]), glm::vec3(a_m[2]) };
+	int mask = 0;
+	for (int lane = 0; lane < b.count; ++lane) {
+		const glm::vec3 b_c(b.center[0][lane], b.center[1][lane], b.center[2][lane]);
+		const glm::vec3 b_h(b.half[0][lane], b.half[1][lane], b.half[2][lane]);
+		glm::vec3 b_axes[3];
+		for (int i = 0; i < 3; ++i) {
+			b_axes[i] = glm::vec3(b.axes[i][0][lane], b.axes[i][1][lane], b.axes[i][2][lane]);
+		}
+		glm::vec3 axes[15];
+		bool valid[15];
+		for (int i = 0; i < 3; ++i) {
+			axes[i] = a_axes[i];
+			axes[i + 3] = b_axes[i];
+			valid[i] = valid[i + 3] = true;
+			for (int j = 0; j < 3; ++j) {
+				const glm::vec3 axis(glm::cross(a_axes[i], b_axes[j]));
+				const float len2 = glm::length2(axis);
+				// skip axes from parallel edges
+				valid[6 + i * 3 + j] = len2 > 1.0e-12f;
+				axes[6 + i * 3 + j] = axis / std::sqrt(std::max(len2, 1.0e-12f));
+			}
+		}
+		bool separated = false;
+		float min_depth = std::numeric_limits<float>::infinity();
+		glm::vec3 min_axis(0.0f);
+		for (int i = 0; i < 15 && !separated; ++i) {
+			if (!valid[i]) continue;
+			const glm::vec3 &axis = axes[i];
+			const float a_proj = glm::dot(a_c, axis);
+			const float a_rad =
+				std::abs(glm::dot(a_axes[0], axis)) * a_h.x +
+				std::abs(glm::dot(a_axes[1], axis)) * a_h.y +
+				std::abs(glm::dot(a_axes[2], axis)) * a_h.z;
+			const float b_proj = glm::dot(b_c, axis);
+			const float b_rad =
+				std::abs(glm::dot(b_axes[0], axis)) * b_h.x +
+				std::abs(glm::dot(b_axes[1], axis)) * b_h.y +
+				std::abs(glm::dot(b_axes[2], axis)) * b_h.z;
+			const float tol = std::max((a_rad + b_rad) * packet_tolerance, packet_min_tolerance);
+			if (a_proj + a_rad + tol < b_proj - b_rad || b_proj + b_rad + tol < a_proj - a_rad) {
+				separated = true;
+				break;
+			}
+			const float overlap = std::min(a_proj + a_rad, b_proj + b_rad) - std::max(a_proj - a_rad, b_proj - b_rad);
+			if (overlap < min_depth) {
+				min_depth = overlap;
+				min_axis = axis;
+			}
+		}
+		if (separated) continue;
+		mask |= 1 << lane;
+		if (normal) normal[lane] = min_axis;
+		if (depth) depth[lane] = min_depth;
+	}
+	return mask;
+}
+
+#endif
+
+
 bool Intersect(
 	const Ray &ray,
 	const AABB &aabb,
@@ -39,6 +39,63 @@ bool Intersect(
 	const glm::dmat4 &b_m,
 	glm::dvec3 &normal,
 	double &depth) noexcept;
+/// same as above, but tries given axis first
+/// if the boxes don't intersect, axis is set to the separating axis,
+/// otherwise to the collision normal, so it can be passed again in
+/// the next test of the same pair
+/// a zero axis means no hint
+bool Intersect(
+	const AABB &a_box,
+	const glm::dmat4 &a_m,
+	const AABB &b_box,
+	const glm::dmat4 &b_m,
+	glm::dvec3 &normal,
+	double &depth,
+	glm::dvec3 &axis) noexcept;
+
+/// up to four oriented boxes in structure of arrays layout
+/// for testing them against one other box at once
+struct OBBPacket {
+
+	static constexpr int SIZE = 4;
+
+	/// centers are stored relative to this point, so they keep their
+	/// precision when converted to float, set before adding boxes
+	/// ideally the center of the box the packet will be tested against
+	glm::dvec3 origin = glm::dvec3(0.0);
+	/// [component][lane]
+	float center[3][SIZE] = {};
+	/// [box axis][component][lane]
+	float axes[3][3][SIZE] = {};
+	/// [box axis][lane]
+	float half[3][SIZE] = {};
+	/// number of lanes in use
+	int count = 0;
+
+	/// put box with given transform into given lane, matrix must not scale
+	void Set(int lane, const AABB &, const glm::dmat4 &) noexcept;
+	/// put box into next free lane, returns false if full
+	bool Add(const AABB &box, const glm::dmat4 &m) noexcept {
+		if (count >= SIZE) return false;
+		Set(count++, box, m);
+		return true;
+	}
+
+};
+
+/// test box a against all boxes in the packet in single precision
+/// returns a bit mask with bit i set if a intersects the box in lane i
+/// intervals are widened by a small tolerance, so this never misses a
+/// pair the double precision test would report, but may report pairs
+/// just out of touch (with a depth slightly below zero)
+/// normal and depth, if given, must have room for SIZE elements and
+/// receive the results for intersecting lanes
+int Intersect(
+	const AABB &a_box,
+	const glm::dmat4 &a_m,
+	const OBBPacket &b,
+	glm::vec3 *normal = nullptr,
+	float *depth = nullptr) noexcept;
 
 
 class Ray {
@@ -5,6 +5,10 @@
 #include <cmath>
 #include <glm/gtx/norm.hpp>
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 
 namespace {
 
@@ -150,6 +154,135 @@ float SimplexNoise::operator ()(const glm::vec3 &in) const noexcept {
 	return 32.0f * n;
 }
 
+#ifdef __SSE2__
+
+namespace {
+
+/// floor for values that fit into an int
+inline __m128 floor(__m128 x) noexcept {
+	const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+	// truncation rounds negative numbers up
+	return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x), _mm_set1_ps(1.0f)));
+}
+
+/// x² + y² + z², in the order glm::length2 adds them
+inline __m128 length2(__m128 x, __m128 y, __m128 z) noexcept {
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+}
+
+}
+
+void SimplexNoise::operator ()(const float *x, const float *y, const float *z, float *out, int count) const noexcept {
+	const __m128 third = _mm_set1_ps(one_third);
+	const __m128 sixth = _mm_set1_ps(one_sixth);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 limit = _mm_set1_ps(0.6f);
+	const __m128 all = _mm_castsi128_ps(_mm_set1_epi32(-1));
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128 in_x = _mm_loadu_ps(x + i);
+		const __m128 in_y = _mm_loadu_ps(y + i);
+		const __m128 in_z = _mm_loadu_ps(z + i);
+
+		const __m128 skew = _mm_mul_ps(_mm_add_ps(_mm_add_ps(in_x, in_y), in_z), third);
+		const __m128 skewed_x = floor(_mm_add_ps(in_x, skew));
+		const __m128 skewed_y = floor(_mm_add_ps(in_y, skew));
+		const __m128 skewed_z = floor(_mm_add_ps(in_z, skew));
+		const __m128 tr = _mm_mul_ps(_mm_add_ps(_mm_add_ps(skewed_x, skewed_y), skewed_z), sixth);
+		const __m128 rel_x = _mm_sub_ps(in_x, _mm_sub_ps(skewed_x, tr));
+		const __m128 rel_y = _mm_sub_ps(in_y, _mm_sub_ps(skewed_y, tr));
+		const __m128 rel_z = _mm_sub_ps(in_z, _mm_sub_ps(skewed_z, tr));
+
+		// same as the second and third corner tables, as masks
+		const __m128 x_ge_y = _mm_cmpge_ps(rel_x, rel_y);
+		const __m128 x_ge_z = _mm_cmpge_ps(rel_x, rel_z);
+		const __m128 y_ge_z = _mm_cmpge_ps(rel_y, rel_z);
+		const __m128 second_x = _mm_and_ps(x_ge_y, _mm_or_ps(x_ge_z, y_ge_z));
+		const __m128 second_y = _mm_andnot_ps(x_ge_y, y_ge_z);
+		const __m128 second_z = _mm_andnot_ps(_mm_or_ps(y_ge_z, _mm_and_ps(x_ge_y, x_ge_z)), all);
+		const __m128 third_x = _mm_or_ps(x_ge_y, _mm_and_ps(x_ge_z, y_ge_z));
+		const __m128 third_y = _mm_or_ps(_mm_andnot_ps(x_ge_y, all), y_ge_z);
+		const __m128 third_z = _mm_andnot_ps(_mm_and_ps(y_ge_z, _mm_or_ps(x_ge_y, x_ge_z)), all);
+
+		__m128 off_x[4] = {
+			rel_x,
+			_mm_add_ps(_mm_sub_ps(rel_x, _mm_and_ps(second_x, one)), sixth),
+			_mm_add_ps(_mm_sub_ps(rel_x, _mm_and_ps(third_x, one)), third),
+			_mm_sub_ps(rel_x, _mm_set1_ps(0.5f)),
+		};
+		__m128 off_y[4] = {
+			rel_y,
+			_mm_add_ps(_mm_sub_ps(rel_y, _mm_and_ps(second_y, one)), sixth),
+			_mm_add_ps(_mm_sub_ps(rel_y, _mm_and_ps(third_y, one)), third),
+			_mm_sub_ps(rel_y, _mm_set1_ps(0.5f)),
+		};
+		__m128 off_z[4] = {
+			rel_z,
+			_mm_add_ps(_mm_sub_ps(rel_z, _mm_and_ps(second_z, one)), sixth),
+			_mm_add_ps(_mm_sub_ps(rel_z, _mm_and_ps(third_z, one)), third),
+			_mm_sub_ps(rel_z, _mm_set1_ps(0.5f)),
+		};
+
+		// permutation lookups have to be done lane by lane
+		alignas(16) int index[3][4];
+		_mm_store_si128(reinterpret_cast<__m128i *>(index[0]), _mm_cvttps_epi32(skewed_x));
+		_mm_store_si128(reinterpret_cast<__m128i *>(index[1]), _mm_cvttps_epi32(skewed_y));
+		_mm_store_si128(reinterpret_cast<__m128i *>(index[2]), _mm_cvttps_epi32(skewed_z));
+		const int st_mask = (_mm_movemask_ps(x_ge_y) << 8) | (_mm_movemask_ps(x_ge_z) << 4) | _mm_movemask_ps(y_ge_z);
+		alignas(16) float grad_x[4][4];
+		alignas(16) float grad_y[4][4];
+		alignas(16) float grad_z[4][4];
+		for (int lane = 0; lane < 4; ++lane) {
+			const int ix = index[0][lane] & 0xFF;
+			const int iy = index[1][lane] & 0xFF;
+			const int iz = index[2][lane] & 0xFF;
+			const unsigned int st =
+				(((st_mask >> (8 + lane)) & 1) << 2) |
+				(((st_mask >> (4 + lane)) & 1) << 1) |
+				((st_mask >> lane) & 1);
+			const glm::ivec3 &second_int = second_ints[st];
+			const glm::ivec3 &third_int = third_ints[st];
+			const int corner[4] = {
+				Perm12(ix + Perm(iy + Perm(iz))),
+				Perm12(ix + second_int.x + Perm(iy + second_int.y + Perm(iz + second_int.z))),
+				Perm12(ix + third_int.x + Perm(iy + third_int.y + Perm(iz + third_int.z))),
+				Perm12(ix + 1 + Perm(iy + 1 + Perm(iz + 1))),
+			};
+			for (int c = 0; c < 4; ++c) {
+				grad_x[c][lane] = Grad(corner[c]).x;
+				grad_y[c][lane] = Grad(corner[c]).y;
+				grad_z[c][lane] = Grad(corner[c]).z;
+			}
+		}
+
+		__m128 n = zero;
+		for (int c = 0; c < 4; ++c) {
+			__m128 t = _mm_min_ps(_mm_max_ps(_mm_sub_ps(limit, length2(off_x[c], off_y[c], off_z[c])), zero), one);
+			t = _mm_mul_ps(t, t);
+			const __m128 dot = _mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_load_ps(grad_x[c]), off_x[c]),
+				_mm_mul_ps(_mm_load_ps(grad_y[c]), off_y[c])),
+				_mm_mul_ps(_mm_load_ps(grad_z[c]), off_z[c]));
+			n = _mm_add_ps(n, _mm_mul_ps(_mm_mul_ps(t, t), dot));
+		}
+		_mm_storeu_ps(out + i, _mm_mul_ps(_mm_set1_ps(32.0f), n));
+	}
+	for (; i < count; ++i) {
+		out[i] = (*this)(glm::vec3(x[i], y[i], z[i]));
+	}
+}
+
+#else
+
+void SimplexNoise::operator ()(const float *x, const float *y, const float *z, float *out, int count) const noexcept {
+	for (int i = 0; i < count; ++i) {
+		out[i] = (*this)(glm::vec3(x[i], y[i], z[i]));
+	}
+}
+
+#endif
+
 
 int SimplexNoise::Perm(int idx) const noexcept {
 	return perm[idx];
@@ -165,47 +298,134 @@ const glm::vec3 &SimplexNoise::Grad(int idx) const noexcept {
 
 
 WorleyNoise::WorleyNoise(unsigned int seed) noexcept
-: seed(seed)
-, num_points(8) {
+: seed(seed) {
+
+}
+
+void WorleyNoise::Points(const glm::vec3 &cube, glm::vec3 *points) const noexcept {
+	unsigned int cube_rand =
+		(unsigned(cube.x) * 130223) ^
+		(unsigned(cube.y) * 159899) ^
+		(unsigned(cube.z) * 190717) ^
+		seed;
+
+	for (int i = 0; i < num_points; ++i) {
+		glm::vec3 &point = points[i];
+		point = cube;
+		cube_rand = 190667 * cube_rand + 109807;
+		point.x += float(cube_rand % 262144) / 262144.0f;
+		cube_rand = 135899 * cube_rand + 189169;
+		point.y += float(cube_rand % 262144) / 262144.0f;
+		cube_rand = 159739 * cube_rand + 112139;
+		point.z += float(cube_rand % 262144) / 262144.0f;
+	}
+}
+
+namespace {
+
+/// offsets of neighbouring cubes, own cube first since it most likely
+/// contains the closest point and allows skipping more of the others
+const glm::ivec3 worley_neighbors[27] = {
+	{  0,  0,  0 },
+	{ -1,  0,  0 }, {  1,  0,  0 }, {  0, -1,  0 }, {  0,  1,  0 }, {  0,  0, -1 }, {  0,  0,  1 },
+	{ -1, -1,  0 }, {  1, -1,  0 }, { -1,  1,  0 }, {  1,  1,  0 },
+	{ -1,  0, -1 }, {  1,  0, -1 }, { -1,  0,  1 }, {  1,  0,  1 },
+	{  0, -1, -1 }, {  0,  1, -1 }, {  0, -1,  1 }, {  0,  1,  1 },
+	{ -1, -1, -1 }, {  1, -1, -1 }, { -1,  1, -1 }, {  1,  1, -1 },
+	{ -1, -1,  1 }, {  1, -1,  1 }, { -1,  1,  1 }, {  1,  1,  1 },
+};
+
+/// squared distance from in to the neighbouring cube at given offset
+/// never more than that of any point inside the cube
+inline float worley_cube_distance2(const glm::vec3 &in, const glm::vec3 &center, const glm::ivec3 &offset) noexcept {
+	glm::vec3 d(0.0f);
+	for (int i = 0; i < 3; ++i) {
+		if (offset[i] < 0) {
+			d[i] = center[i] - in[i];
+		} else if (offset[i] > 0) {
+			d[i] = (center[i] + 1.0f) - in[i];
+		}
+	}
+	return glm::length2(d);
+}
+
+/// feature points of one cube, for reuse by nearby samples
+template<int N>
+struct WorleyCell {
+	glm::vec3 cube;
+	bool valid = false;
+	glm::vec3 points[N];
+};
 
 }
 
 float WorleyNoise::operator ()(const glm::vec3 &in) const noexcept {
 	glm::vec3 center = glm::floor(in);
 
+	// compare squared distances, it's the same order
 	float closest = 1.0f;  // cannot be farther away than 1.0
+	glm::vec3 points[num_points];
 
-	for (int z = -1; z <= 1; ++z) {
-		for (int y = -1; y <= 1; ++y) {
-			for (int x = -1; x <= 1; ++x) {
-				glm::vec3 cube(center.x + x, center.y + y, center.z + z);
-				unsigned int cube_rand =
-					(unsigned(cube.x) * 130223) ^
-					(unsigned(cube.y) * 159899) ^
-					(unsigned(cube.z) * 190717) ^
-					seed;
-
-				for (int i = 0; i < num_points; ++i) {
-					glm::vec3 point(cube);
-					cube_rand = 190667 * cube_rand + 109807;
-					point.x += float(cube_rand % 262144) / 262144.0f;
-					cube_rand = 135899 * cube_rand + 189169;
-					point.y += float(cube_rand % 262144) / 262144.0f;
-					cube_rand = 159739 * cube_rand + 112139;
-					point.z += float(cube_rand % 262144) / 262144.0f;
-
-					float distance = glm::distance(in, point);
-					if (distance < closest) {
-						closest = distance;
-					}
-				}
+	for (const glm::ivec3 &offset : worley_neighbors) {
+		if (worley_cube_distance2(in, center, offset) >= closest) {
+			// no point in there can be closer
+			continue;
+		}
+		Points(glm::vec3(center.x + offset.x, center.y + offset.y, center.z + offset.z), points);
+		for (const glm::vec3 &point : points) {
+			float distance = glm::length2(point - in);
+			if (distance < closest) {
+				closest = distance;
 			}
 		}
 	}
 
 	// closest ranges (0, 1), so normalizing to (-1,1) is trivial
 	// though heavily biased towards lower numbers
-	return 2.0f * closest - 1.0f;
+	return 2.0f * std::sqrt(closest) - 1.0f;
+}
+
+void WorleyNoise::operator ()(const float *x, const float *y, const float *z, float *f1, float *f2, int count) const noexcept {
+	// neighbouring samples mostly share cubes, so keep their points around
+	constexpr int cache_size = 64;
+	WorleyCell<num_points> cache[cache_size];
+
+	for (int s = 0; s < count; ++s) {
+		const glm::vec3 in(x[s], y[s], z[s]);
+		const glm::vec3 center = glm::floor(in);
+
+		float closest = 1.0f;
+		float second = 1.0f;
+		for (const glm::ivec3 &offset : worley_neighbors) {
+			if (worley_cube_distance2(in, center, offset) >= (f2 ? second : closest)) {
+				continue;
+			}
+			const glm::vec3 cube(center.x + offset.x, center.y + offset.y, center.z + offset.z);
+			const unsigned int hash =
+				(unsigned(int(cube.x)) * 7u) ^
+				(unsigned(int(cube.y)) * 13u) ^
+				(unsigned(int(cube.z)) * 31u);
+			WorleyCell<num_points> &cell = cache[hash % cache_size];
+			if (!cell.valid || cell.cube.x != cube.x || cell.cube.y != cube.y || cell.cube.z != cube.z) {
+				cell.cube = cube;
+				cell.valid = true;
+				Points(cube, cell.points);
+			}
+			for (const glm::vec3 &point : cell.points) {
+				float distance = glm::length2(point - in);
+				if (distance < closest) {
+					second = closest;
+					closest = distance;
+				} else if (distance < second) {
+					second = distance;
+				}
+			}
+		}
+		f1[s] = std::sqrt(closest);
+		if (f2) {
+			f2[s] = std::sqrt(second);
+		}
+	}
 }
 
 }
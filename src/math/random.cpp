@@ -0,0 +1,53 @@
+#include "GaloisLFSR.hpp"
+
+#include <vector>
+
+
+namespace blobs {
+namespace math {
+
+namespace {
+
+/// linear map on 64 bit vectors over GF(2), column i is the image of bit i
+struct BitMatrix {
+	std::uint64_t col[64];
+
+	std::uint64_t operator *(std::uint64_t v) const noexcept {
+		std::uint64_t result = 0;
+		for (int i = 0; v; ++i, v >>= 1) {
+			if (v & 1) {
+				result ^= col[i];
+			}
+		}
+		return result;
+	}
+};
+
+}
+
+void GaloisLFSR::Jump(std::uint64_t n) noexcept {
+	// stepping is linear, so jump[k] advancing by 2^k bits can be
+	// derived from the single step by repeated squaring
+	static const std::vector<BitMatrix> jump = []() {
+		std::vector<BitMatrix> table(64);
+		for (int i = 0; i < 64; ++i) {
+			GaloisLFSR single(std::uint64_t(1) << i);
+			single();
+			table[0].col[i] = single.state;
+		}
+		for (int k = 1; k < 64; ++k) {
+			for (int i = 0; i < 64; ++i) {
+				table[k].col[i] = table[k - 1] * table[k - 1].col[i];
+			}
+		}
+		return table;
+	}();
+	for (int k = 0; n; ++k, n >>= 1) {
+		if (n & 1) {
+			state = jump[k] * state;
+		}
+	}
+}
+
+}
+}
@@ -1,17 +1,21 @@
 #ifndef BLOBS_WORLD_BODY_HPP_
 #define BLOBS_WORLD_BODY_HPP_
 
+#include "CreatureCreatureCollision.hpp"
 #include "Orbit.hpp"
 #include "../math/geometry.hpp"
 #include "../math/glm.hpp"
 
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 
 namespace blobs {
 namespace app {
 	class Assets;
+	class ThreadPool;
 }
 namespace creature {
 	class Creature;
@@ -90,14 +94,29 @@ public:
 	const glm::dmat4 &ToParent() const noexcept { return inverse_orbital; }
 	const glm::dmat4 &FromParent() const noexcept { return orbital; }
 
-	glm::dmat4 ToUniverse() const noexcept;
-	glm::dmat4 FromUniverse() const noexcept;
+	/// cached transforms between this body's and the root's frame
+	const glm::dmat4 &ToUniverse() const noexcept { return to_universe; }
+	const glm::dmat4 &FromUniverse() const noexcept { return from_universe; }
 
 	virtual void Draw(app::Assets &, graphics::Viewport &) { }
 
+	/// update rotation
 	void Tick(double dt);
+	/// advance creature movement, only touches this body's creatures,
+	/// so different bodies may do this concurrently
+	void MoveCreatures();
+	/// update stats and brains of creatures moved in the last call to
+	/// MoveCreatures() and remove the dead, may touch the simulation
+	void UpdateCreatures();
+	/// update orbital position and transforms of this body and all
+	/// its descendants, parent's transforms must be up to date
 	void Cache() noexcept;
+	/// find colliding creatures, only touches this body, so different
+	/// bodies may do this concurrently
 	void CheckCollision() noexcept;
+	/// separate the creatures found colliding in the last call to
+	/// CheckCollision() and let them react, may touch the simulation
+	void ResolveCollisions();
 
 	void AddCreature(creature::Creature *);
 	void RemoveCreature(creature::Creature *);
@@ -128,10 +147,36 @@ private:
 	glm::dmat4 inverse_orbital;
 	glm::dmat4 local;
 	glm::dmat4 inverse_local;
+	glm::dmat4 to_universe;
+	glm::dmat4 from_universe;
 
 	std::vector<creature::Creature *> creatures;
 	int atmosphere;
 
+	/// scratch space for ticking creatures
+	std::vector<creature::Creature *> ccache;
+	/// whether the creature at the same index in ccache was moved,
+	/// decided once per tick since moving may change its interval
+	std::vector<bool> cdue;
+	std::vector<CreatureCreatureCollision> collisions;
+
+	/// creature's collision box, bounding sphere, and extent along the sweep axis
+	struct CollisionCandidate {
+		creature::Creature *c;
+		math::AABB box;
+		glm::dmat4 transform;
+		glm::dvec3 center;
+		double radius;
+		double min;
+		double max;
+	};
+	std::vector<CollisionCandidate> candidates;
+
+	/// last separating axis or collision normal of creature pairs that
+	/// were close enough to be tested in the previous collision check
+	using ContactCache = std::map<std::pair<const creature::Creature *, const creature::Creature *>, glm::dvec3>;
+	ContactCache contacts;
+
 };
 
 }
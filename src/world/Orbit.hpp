@@ -3,6 +3,8 @@
 
 #include "../math/glm.hpp"
 
+#include <vector>
+
 
 namespace blobs {
 namespace world {
@@ -32,10 +34,20 @@ public:
 	double MeanAnomaly() const noexcept;
 	Orbit &MeanAnomaly(double) noexcept;
 
+	/// number of eccentric anomaly samples taken over one period
+	/// for quicker solving of Kepler's equation, 0 to disable
+	int Resolution() const noexcept;
+	Orbit &Resolution(int);
+
+	/// eccentric anomaly at position t in the orbit
+	double EccentricAnomaly(double t) const noexcept;
+
 	/// calculate transformation matrix at position t in the
 	/// orbit, measured in degrees from mean anomaly at t=0
 	glm::dmat4 Matrix(double t) const noexcept;
 	glm::dmat4 InverseMatrix(double t) const noexcept;
+	/// calculate both of the above with a single solve
+	void Matrices(double t, glm::dmat4 &matrix, glm::dmat4 &inverse) const noexcept;
 
 private:
 	double sma; // semi-major axis
@@ -45,6 +57,12 @@ private:
 	double arg; // argument of periapsis
 	double mna; // mean anomaly (at t=0)
 
+	/// eccentric anomaly for evenly spaced mean anomalies in [0,2π]
+	std::vector<double> ephemeris;
+
+private:
+	void BuildEphemeris();
+
 };
 
 }
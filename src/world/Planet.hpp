@@ -5,10 +5,12 @@
 
 #include "Set.hpp"
 #include "Tile.hpp"
-#include "../graphics/SimpleVAO.hpp"
+#include "../graphics/BufferTexture.hpp"
+#include "../graphics/EmptyVAO.hpp"
 #include "../math/glm.hpp"
 
 #include <cassert>
+#include <iosfwd>
 #include <memory>
 #include <vector>
 #include <GL/glew.h>
@@ -60,6 +62,44 @@ public:
 	// center point of tile on surface at elevation
 	glm::dvec3 TileCenter(int surface, int x, int y, double elevation = 0.0) const noexcept;
 
+	/// Get the index of the tile below given point.
+	int TileIndexAt(const glm::dvec3 &) const noexcept;
+	/// Get the tile with given index.
+	const Tile &TileAt(int index) const noexcept { return tiles[index]; }
+	const TileType &TypeAt(int index) const noexcept;
+	/// center point of tile with given index at elevation
+	glm::dvec3 TileCenter(int index, double elevation = 0.0) const noexcept;
+	/// Number of tiles on all surfaces combined.
+	int TileCount() const noexcept { return TilesTotal(); }
+	/// Get the indices of the four tiles adjacent to given one.
+	/// See TileVicinity for larger neighbourhoods.
+	const int *NeighborsOf(int index) const noexcept { return &adjacency[index * 4]; }
+
+	/// Change the type of a tile, keeping resource lookups and the
+	/// copy used for drawing up to date.
+	/// Use this instead of writing to TileAt() once the planet is in use.
+	void SetTileType(int surface, int x, int y, int type);
+
+	/// Fraction of given tile's capacity that is currently available,
+	/// including regrowth since it was last depleted.
+	double TileStock(int index) const noexcept;
+	/// Take up to given amount of resources from a tile.
+	/// @return the amount taken, less than requested if the tile runs out
+	double DepleteTile(int index, double amount) noexcept;
+
+	/// Get the index of the tile closest to given one which yields
+	/// given resource, or -1 if there is no such tile.
+	int NearestResourceTile(int resource, int tile) const;
+	/// Get the number of tile steps to the tile returned by
+	/// NearestResourceTile() or -1 if there is no such tile.
+	int ResourceDistance(int resource, int tile) const;
+
+	/// Replace all tile types with raw data from given stream.
+	/// @return false if the stream ran out early, tiles are undefined then
+	bool ReadTiles(std::istream &);
+	/// Write all tile types as raw data to given stream.
+	void WriteTiles(std::ostream &) const;
+
 	void BuildVAO();
 	void Draw(app::Assets &, graphics::Viewport &) override;
 
@@ -80,23 +120,85 @@ private:
 		return 6 * TilesPerSurface();
 	}
 
+	/// Link each tile to its four neighbours, including across surfaces.
+	void BuildAdjacency();
+
+	/// Split the surfaces into a quadtree of chunks for Draw().
+	void BuildChunks();
+	/// Add the chunk covering (chunk_size << level)² tiles starting at
+	/// given coordinates along with all its descendants.
+	/// @return the chunk's index
+	int BuildChunk(int surface, int x, int y, int level);
+
+	/// Copy tiles changed since the last call to the tile texture.
+	void UploadTiles();
+
+	/// Make sure the field for given resource is valid.
+	void UpdateResourceField(int resource) const;
+	/// Lower distances in given resource's field starting from tile.
+	void RelaxResourceField(int resource, int tile) const;
+
 private:
 	int sidelength;
 	std::vector<Tile> tiles;
-
-	struct Attributes {
-		glm::vec3 position;
+	std::vector<int> adjacency;
+
+	/// per tile stock as of the time it was last depleted,
+	/// regrowth is applied when reading
+	std::vector<float> stock;
+	std::vector<double> stock_time;
+
+	/// For each tile the closest one yielding a resource.
+	struct ResourceField {
+		bool valid = false;
+		std::vector<int> nearest;
+		std::vector<int> distance;
+	};
+	mutable std::vector<ResourceField> resource_fields;
+
+	/// vertices are generated by the planet surface shader,
+	/// which looks up tile types in a copy of tiles
+	std::unique_ptr<graphics::EmptyVAO> vao;
+	std::unique_ptr<graphics::BufferTexture> tile_texture;
+	/// indices of tiles changed after BuildVAO(), uploaded on next draw
+	std::vector<int> dirty_tiles;
+	/// upload unchanged tiles between dirty ones if the gap is shorter
+	/// than this, fewer and larger uploads are cheaper
+	static constexpr int dirty_gap = 32;
+
+	/// Node of a surface's LOD quadtree. Chunks on level 0 draw one quad
+	/// per tile, each level up covers twice the tiles per side with the
+	/// same number of quads.
+	struct Chunk {
+		int surface;
+		int x;
+		int y;
+		int level;
+		/// indices of up to four children, -1 if absent
+		int children[4];
+		/// bounding sphere in model space
+		glm::vec3 center;
+		float radius;
+		/// direction of the chunk's center and the largest angle
+		/// between it and any point of the chunk
 		glm::vec3 normal;
-		glm::vec3 tex_coord;
-		float shiny;
-		float glossy;
-		float metallic;
+		float spread;
+		/// quads per row and vertices in total
+		int columns;
+		int count;
 	};
-	std::unique_ptr<graphics::SimpleVAO<Attributes, unsigned int>> vao;
+	/// in tiles per side on level 0
+	static constexpr int chunk_size = 16;
+	/// refine chunks whose quads appear larger than this many pixels
+	static constexpr float lod_threshold = 4.0f;
+	std::vector<Chunk> chunks;
+	int chunk_roots[6];
 
 };
 
-void GenerateEarthlike(const Set<TileType> &, Planet &) noexcept;
+void GenerateEarthlike(const Set<TileType> &, Planet &);
+/// same as above, with tile rows spread over given pool
+void GenerateEarthlike(const Set<TileType> &, Planet &, app::ThreadPool &);
 void GenerateTest(const Set<TileType> &, Planet &) noexcept;
 
 }
@@ -4,9 +4,12 @@
 #include "Record.hpp"
 #include "Set.hpp"
 #include "../app/Assets.hpp"
+#include "../app/ThreadPool.hpp"
+#include "../math/glm.hpp"
+#include "../math/Integrator.hpp"
 
+#include <cstdint>
 #include <iosfwd>
-#include <set>
 #include <vector>
 
 
@@ -35,8 +38,13 @@ public:
 	Simulation &operator =(Simulation &&) = delete;
 
 public:
+	/// advance simulation by dt, which may be a lot longer than a frame
 	void Tick(double dt);
 
+	/// longest step used for creature movement and collisions
+	void MaxStep(double s) noexcept { max_step = s; }
+	double MaxStep() const noexcept { return max_step; }
+
 	app::Assets &Assets() noexcept { return assets; }
 	const app::Assets &Assets() const noexcept { return assets; }
 	const Set<Resource> &Resources() const noexcept { return assets.data.resources; }
@@ -46,9 +54,10 @@ public:
 	void AddPlanet(Planet &);
 	void AddSun(Sun &);
 
-	const std::set<Body *> &Bodies() const noexcept { return bodies; }
-	const std::set<Planet *> &Planets() const noexcept { return planets; }
-	const std::set<Sun *> &Suns() const noexcept { return suns; }
+	/// all bodies in the order they were added, parents before children
+	const std::vector<Body *> &Bodies() const noexcept { return bodies; }
+	const std::vector<Planet *> &Planets() const noexcept { return planets; }
+	const std::vector<Sun *> &Suns() const noexcept { return suns; }
 	Planet &PlanetByName(const std::string &);
 
 	void SetAlive(creature::Creature *);
@@ -61,25 +70,66 @@ public:
 
 	double Time() const noexcept { return time; }
 
+	/// for spreading independent work over cores
+	app::ThreadPool &Pool() noexcept { return pool; }
+
+	/// base for creatures' random streams
+	void Seed(std::uint64_t s) noexcept { seed = s; }
+	std::uint64_t Seed() const noexcept { return seed; }
+	/// lineage for a creature without parents
+	std::uint64_t NextLineage() noexcept { return ++lineages; }
+
+	/// creatures close to the focus point on given body are simulated
+	/// in full detail, others are updated less frequently
+	void SetFocus(const Body &, const glm::dvec3 &pos, const creature::Creature * = nullptr) noexcept;
+	/// number of ticks between updates of given creature
+	int TickInterval(const creature::Creature &) const noexcept;
+	/// check if given creature is to be updated in the current tick
+	bool DueForTick(const creature::Creature &) const noexcept;
+
+	/// set integration schemes for creatures updated every tick
+	/// and for those updated less frequently
+	void SetIntegrator(math::Integrator full_detail, math::Integrator reduced_detail) noexcept;
+	/// integration scheme to use for given creature
+	math::Integrator GetIntegrator(const creature::Creature &) const noexcept;
+
 	const std::vector<Record> &Records() const noexcept { return records; }
 	void CheckRecords(creature::Creature &) noexcept;
 	void LogRecord(const Record &);
 
 	std::ostream &Log();
 
+private:
+	/// number of steps needed to stably advance creatures by dt
+	int SubSteps(double dt) const noexcept;
+
 private:
 	app::Assets &assets;
 
-	std::set<Body *> bodies;
-	std::set<Planet *> planets;
-	std::set<Sun *> suns;
+	std::vector<Body *> bodies;
+	std::vector<Planet *> planets;
+	std::vector<Sun *> suns;
 
 	std::vector<creature::Creature *> alive;
 	std::vector<creature::Creature *> dead;
 
 	double time;
+	unsigned long ticks;
+	std::uint64_t seed;
+	std::uint64_t lineages;
+	double max_step;
+
+	const Body *focus_body;
+	glm::dvec3 focus_pos;
+	const creature::Creature *focus_creature;
+
+	math::Integrator full_integrator;
+	math::Integrator reduced_integrator;
 	std::vector<Record> records;
 
+	/// spreads work on independent bodies over cores
+	app::ThreadPool pool;
+
 };
 
 }
@@ -23,6 +23,11 @@ struct TileType {
 	double glossy = 0.5;
 	double metallic = 0.0;
 
+	/// amount of resources a tile of this type holds when full
+	double capacity = 10.0;
+	/// fraction of the capacity regained per second
+	double regrowth = 0.01;
+
 	struct Yield {
 		int resource;
 		double ubiquity;
@@ -0,0 +1,54 @@
+#ifndef BLOBS_WORLD_TILEVICINITY_HPP_
+#define BLOBS_WORLD_TILEVICINITY_HPP_
+
+#include <vector>
+
+
+namespace blobs {
+namespace world {
+
+class Planet;
+
+/// Indices of the tiles within a number of steps from a center tile,
+/// sorted by step count. Steps follow the planet's adjacency, so they
+/// cross surface edges like any other.
+class TileVicinity {
+
+public:
+	/// range of tile indices
+	struct Range {
+		const int *first;
+		const int *last;
+		const int *begin() const noexcept { return first; }
+		const int *end() const noexcept { return last; }
+		int size() const noexcept { return last - first; }
+	};
+
+public:
+	TileVicinity(const Planet &, int center, int radius);
+
+public:
+	int Center() const noexcept { return tiles.front(); }
+	int Radius() const noexcept { return ring_offset.size() - 2; }
+
+	/// all tiles, closest first
+	Range Tiles() const noexcept { return Range{ tiles.data(), tiles.data() + tiles.size() }; }
+	/// tiles exactly given number of steps away from the center
+	Range Ring(int steps) const noexcept {
+		return Range{ tiles.data() + ring_offset[steps], tiles.data() + ring_offset[steps + 1] };
+	}
+
+	const int *begin() const noexcept { return tiles.data(); }
+	const int *end() const noexcept { return tiles.data() + tiles.size(); }
+
+private:
+	std::vector<int> tiles;
+	/// ring n occupies [ring_offset[n],ring_offset[n+1]) of tiles
+	std::vector<int> ring_offset;
+
+};
+
+}
+}
+
+#endif
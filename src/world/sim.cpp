@@ -8,6 +8,7 @@
 #include "../ui/string.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 
 
@@ -77,7 +78,17 @@ Simulation::Simulation(app::Assets &assets)
 , alive()
 , dead()
 , time(0.0)
-, records(7) {
+, ticks(0)
+, seed(0)
+, lineages(0)
+, max_step(1.0 / 60.0)
+, focus_body(nullptr)
+, focus_pos(0.0)
+, focus_creature(nullptr)
+, full_integrator(math::RK4)
+, reduced_integrator(math::VERLET)
+, records(7)
+, pool() {
 	records[0].name = "Age";
 	records[0].type = Record::TIME;
 	records[1].name = "Mass";
@@ -100,28 +111,106 @@ Simulation::~Simulation() {
 }
 
 void Simulation::Tick(double dt) {
-	time += dt;
+	// creature movement and collisions need small steps to stay stable
+	const int steps = SubSteps(dt);
+	const double step = dt / steps;
+	for (int i = 0; i < steps; ++i) {
+		time += step;
+		++ticks;
+		// creatures only ever move on their own body
+		pool.Run(bodies.size(), [this](int i) { bodies[i]->MoveCreatures(); });
+		// but they may be born, die, or set records anywhere
+		for (auto body : bodies) {
+			body->UpdateCreatures();
+		}
+		pool.Run(bodies.size(), [this](int i) { bodies[i]->CheckCollision(); });
+		// reactions may draw on shared state, so apply them in order
+		for (auto body : bodies) {
+			body->ResolveCollisions();
+		}
+	}
+	// orbits and records are fine with one big step
 	for (auto body : bodies) {
 		body->Tick(dt);
 	}
+	// propagate transforms from the roots down, so parents are
+	// always up to date before their children
+	for (auto body : bodies) {
+		if (!body->HasParent()) {
+			body->Cache();
+		}
+	}
 	for (auto c : alive) {
 		CheckRecords(*c);
 	}
 }
 
+int Simulation::SubSteps(double dt) const noexcept {
+	double step = max_step;
+	for (auto c : alive) {
+		// don't let anyone move more than half its size per step
+		const double speed = glm::length(c->GetSituation().Velocity());
+		if (speed * step > c->Size() * 0.5) {
+			step = c->Size() * 0.5 / speed;
+		}
+	}
+	// but don't go overboard either
+	step = std::max(step, max_step * 0.125);
+	return std::max(1, int(std::ceil(dt / step - 1.0e-9)));
+}
+
+void Simulation::SetFocus(const Body &b, const glm::dvec3 &p, const creature::Creature *c) noexcept {
+	focus_body = &b;
+	focus_pos = p;
+	focus_creature = c;
+}
+
+int Simulation::TickInterval(const creature::Creature &c) const noexcept {
+	if (!focus_body || &c == focus_creature) {
+		return 1;
+	}
+	const creature::Situation &s = c.GetSituation();
+	if (!s.OnPlanet() || &s.GetPlanet() != focus_body) {
+		// not even looking at the same body
+		return 8;
+	}
+	const double dist = glm::length2(s.Position() - focus_pos);
+	if (dist < 16.0 * 16.0) {
+		return 1;
+	} else if (dist < 48.0 * 48.0) {
+		return 2;
+	} else {
+		return 4;
+	}
+}
+
+bool Simulation::DueForTick(const creature::Creature &c) const noexcept {
+	// phase spreads creatures of the same interval over ticks
+	return (ticks + c.TickPhase()) % TickInterval(c) == 0;
+}
+
+void Simulation::SetIntegrator(math::Integrator full, math::Integrator reduced) noexcept {
+	full_integrator = full;
+	reduced_integrator = reduced;
+}
+
+math::Integrator Simulation::GetIntegrator(const creature::Creature &c) const noexcept {
+	return TickInterval(c) > 1 ? reduced_integrator : full_integrator;
+}
+
 void Simulation::AddBody(Body &b) {
 	b.SetSimulation(*this);
-	bodies.insert(&b);
+	bodies.push_back(&b);
 }
 
 void Simulation::AddPlanet(Planet &p) {
 	AddBody(p);
-	planets.insert(&p);
+	planets.push_back(&p);
 }
 
 void Simulation::AddSun(Sun &s) {
 	AddBody(s);
-	suns.insert(&s);
+	suns.push_back(&s);
 }
 
 Planet &Simulation::PlanetByName(const std::string &name) {
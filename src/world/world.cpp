@@ -8,8 +8,10 @@
 #include "Sun.hpp"
 #include "Tile.hpp"
 #include "TileType.hpp"
+#include "TileVicinity.hpp"
 
 #include "../app/Assets.hpp"
+#include "../app/ThreadPool.hpp"
 #include "../creature/Composition.hpp"
 #include "../creature/Creature.hpp"
 #include "../graphics/Viewport.hpp"
@@ -20,7 +22,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <vector>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/euler_angles.hpp>
 #include <glm/gtx/io.hpp>
@@ -49,8 +53,15 @@ Body::Body()
 , inverse_orbital(1.0)
 , local(1.0)
 , inverse_local(1.0)
+, to_universe(1.0)
+, from_universe(1.0)
 , creatures()
-, atmosphere(-1) {
+, atmosphere(-1)
+, ccache()
+, cdue()
+, collisions()
+, candidates()
+, contacts() {
 }
 
 Body::~Body() {
@@ -132,37 +143,31 @@ double Body::SphereOfInfluence() const noexcept {
 	}
 }
 
-glm::dmat4 Body::ToUniverse() const noexcept {
-	glm::dmat4 m(1.0);
-	const Body *b = this;
-	while (b->HasParent()) {
-		m = b->ToParent() * m;
-		b = &b->Parent();
-	}
-	return m;
+void Body::Tick(double dt) {
+	rotation += dt * AngularMomentum() / Inertia();
 }
 
-glm::dmat4 Body::FromUniverse() const noexcept {
-	glm::dmat4 m(1.0);
-	const Body *b = this;
-	while (b->HasParent()) {
-		m *= b->FromParent();
-		b = &b->Parent();
+void Body::MoveCreatures() {
+	ccache = Creatures();
+	cdue.assign(ccache.size(), false);
+	for (std::size_t i = 0; i < ccache.size(); ++i) {
+		creature::Creature *c = ccache[i];
+		if (GetSimulation().DueForTick(*c)) {
+			cdue[i] = true;
+			c->TickMotion(GetSimulation().Time() - c->LastTick());
+		}
 	}
-	return m;
-}
-
-namespace {
-std::vector<creature::Creature *> ccache;
-std::vector<CreatureCreatureCollision> collisions;
 }
 
-void Body::Tick(double dt) {
-	rotation += dt * AngularMomentum() / Inertia();
-	Cache();
-	ccache = Creatures();
-	for (creature::Creature *c : ccache) {
-		c->Tick(dt);
+void Body::UpdateCreatures() {
+	for (std::size_t i = 0; i < ccache.size(); ++i) {
+		creature::Creature *c = ccache[i];
+		if (cdue[i]) {
+			c->TickLife();
+		} else {
+			// deaths must not wait for the next update
+			c->CheckStats();
+		}
 	}
 	// first remove creatures so they don't collide
 	for (auto c = Creatures().begin(); c != Creatures().end();) {
@@ -173,45 +178,99 @@ void Body::Tick(double dt) {
 			++c;
 		}
 	}
-	CheckCollision();
 }
 
 void Body::Cache() noexcept {
 	if (parent) {
-		orbital =
-			orbit.Matrix(PI * 2.0 * (GetSimulation().Time() / OrbitalPeriod()))
-			* glm::eulerAngleXY(axis_tilt.x, axis_tilt.y);
-		inverse_orbital =
-			glm::eulerAngleYX(-axis_tilt.y, -axis_tilt.x)
-			* orbit.InverseMatrix(PI * 2.0 * (GetSimulation().Time() / OrbitalPeriod()));
+		glm::dmat4 orbit_matrix;
+		glm::dmat4 inverse_orbit_matrix;
+		orbit.Matrices(
+			PI * 2.0 * (GetSimulation().Time() / OrbitalPeriod()),
+			orbit_matrix, inverse_orbit_matrix);
+		orbital = orbit_matrix * glm::eulerAngleXY(axis_tilt.x, axis_tilt.y);
+		inverse_orbital = glm::eulerAngleYX(-axis_tilt.y, -axis_tilt.x) * inverse_orbit_matrix;
+		to_universe = parent->to_universe * inverse_orbital;
+		from_universe = orbital * parent->from_universe;
 	} else {
 		orbital = glm::eulerAngleXY(axis_tilt.x, axis_tilt.y);
 		inverse_orbital = glm::eulerAngleYX(-axis_tilt.y, -axis_tilt.x);
+		to_universe = glm::dmat4(1.0);
+		from_universe = glm::dmat4(1.0);
 	}
 	local = glm::eulerAngleY(rotation);
 	inverse_local = glm::eulerAngleY(-rotation);
+	for (Body *child : children) {
+		child->Cache();
+	}
 }
 
 void Body::CheckCollision() noexcept {
-	if (Creatures().size() < 2) return;
 	collisions.clear();
-	auto end = Creatures().end();
-	for (auto i = Creatures().begin(); i != end; ++i) {
-		math::AABB i_box((*i)->CollisionBounds());
-		glm::dmat4 i_mat((*i)->CollisionTransform());
-		for (auto j = (i + 1); j != end; ++j) {
-			glm::dvec3 diff((*i)->GetSituation().Position() - (*j)->GetSituation().Position());
-			double max_dist = ((*i)->Size() + (*j)->Size()) * 1.74;
-			if (glm::length2(diff) > max_dist * max_dist) continue;
-			math::AABB j_box((*j)->CollisionBounds());
-			glm::dmat4 j_mat((*j)->CollisionTransform());
+	if (Creatures().size() < 2) {
+		contacts.clear();
+		return;
+	}
+
+	// broadphase: sort bounding spheres along x and sweep
+	candidates.clear();
+	for (creature::Creature *c : Creatures()) {
+		const glm::dmat4 transform(c->CollisionTransform());
+		const glm::dvec3 center(transform[3]);
+		// half the diagonal of the cube
+		const double radius = c->Size() * 0.8660254037844386;
+		candidates.push_back({ c, c->CollisionBounds(), transform, center, radius, center.x - radius, center.x + radius });
+	}
+	std::sort(candidates.begin(), candidates.end(), [](const CollisionCandidate &a, const CollisionCandidate &b) {
+		return a.min < b.min;
+	});
+
+	ContactCache seen;
+	math::OBBPacket packet;
+	const CollisionCandidate *lanes[math::OBBPacket::SIZE];
+	auto flush = [&](const CollisionCandidate &a) {
+		// midphase: single precision SAT against the whole packet,
+		// errs on the side of a hit, so it only ever saves work
+		const int hits = Intersect(a.box, a.transform, packet);
+		for (int lane = 0; lane < packet.count; ++lane) {
+			const CollisionCandidate &b = *lanes[lane];
+			const auto key = a.c < b.c ? std::make_pair(a.c, b.c) : std::make_pair(b.c, a.c);
+			auto cached = contacts.find(key);
+			glm::dvec3 axis(cached != contacts.end() ? cached->second : glm::dvec3(0.0));
 			glm::dvec3 normal;
 			double depth;
-			if (Intersect(i_box, i_mat, j_box, j_mat, normal, depth)) {
-				collisions.push_back({ **i, **j, normal, depth });
+			// narrowphase: SAT, starting with what separated them last time
+			if ((hits & (1 << lane)) && Intersect(a.box, a.transform, b.box, b.transform, normal, depth, axis)) {
+				collisions.push_back({ *a.c, *b.c, normal, depth });
 			}
+			seen.emplace(key, axis);
+		}
+		packet.count = 0;
+	};
+	auto end = candidates.end();
+	for (auto i = candidates.begin(); i != end; ++i) {
+		// keep the packet's float coordinates small
+		packet.origin = i->center;
+		for (auto j = (i + 1); j != end && j->min <= i->max; ++j) {
+			// resting creatures can't bump into each other
+			if (i->c->GetSituation().Resting() && j->c->GetSituation().Resting()) continue;
+			// bounding spheres
+			const double max_dist = i->radius + j->radius;
+			if (glm::length2(i->center - j->center) > max_dist * max_dist) continue;
+			lanes[packet.count] = &*j;
+			packet.Add(j->box, j->transform);
+			if (packet.count == math::OBBPacket::SIZE) {
+				flush(*i);
+			}
+		}
+		if (packet.count > 0) {
+			flush(*i);
 		}
 	}
+	// forget pairs that drifted apart
+	contacts.swap(seen);
+}
+
+void Body::ResolveCollisions() {
 	for (auto &c : collisions) {
 		c.A().OnCollide(c.B());
 		c.B().OnCollide(c.A());
@@ -254,13 +313,38 @@ const glm::dvec3 &CreatureCreatureCollision::BVel() const noexcept {
 }
 
 
+namespace {
+
+double mean2eccentric(double M, double e, double E) {
+	// E is the initial guess, solve M = E - e sin E
+	// limit to 100 steps to prevent deadlocks in impossible situations
+	for (int i = 0; i < 100; ++i) {
+		double dE = (E - e * sin(E) - M) / (1 - e * cos(E));
+		E -= dE;
+		if (std::abs(dE) < 1.0e-6) break;
+	}
+	return E;
+}
+
+double mean2eccentric(double M, double e) {
+	return mean2eccentric(M, e, M);
+}
+
+/// above this, E changes too abruptly around periapsis for the
+/// interpolated guess to be any good
+constexpr double max_ephemeris_ecc = 0.8;
+
+}
+
 Orbit::Orbit()
 : sma(1.0)
 , ecc(0.0)
 , inc(0.0)
 , asc(0.0)
 , arg(0.0)
-, mna(0.0) {
+, mna(0.0)
+, ephemeris(257) {
+	BuildEphemeris();
 }
 
 Orbit::~Orbit() {
@@ -281,6 +365,7 @@ double Orbit::Eccentricity() const noexcept {
 
 Orbit &Orbit::Eccentricity(double e) noexcept {
 	ecc = e;
+	BuildEphemeris();
 	return *this;
 }
 
@@ -320,24 +405,62 @@ Orbit &Orbit::MeanAnomaly(double m) noexcept {
 	return *this;
 }
 
-namespace {
+int Orbit::Resolution() const noexcept {
+	return ephemeris.empty() ? 0 : ephemeris.size() - 1;
+}
 
-double mean2eccentric(double M, double e) {
-	double E = M; // eccentric anomaly, solve M = E - e sin E
-	// limit to 100 steps to prevent deadlocks in impossible situations
-	for (int i = 0; i < 100; ++i) {
-		double dE = (E - e * sin(E) - M) / (1 - e * cos(E));
-		E -= dE;
-		if (std::abs(dE) < 1.0e-6) break;
+Orbit &Orbit::Resolution(int r) {
+	ephemeris.resize(r > 0 ? r + 1 : 0);
+	BuildEphemeris();
+	return *this;
+}
+
+void Orbit::BuildEphemeris() {
+	if (ephemeris.empty() || ecc > max_ephemeris_ecc) return;
+	const int samples = Resolution();
+	double E = 0.0;
+	for (int i = 0; i <= samples; ++i) {
+		const double M = PI * 2.0 * double(i) / double(samples);
+		// previous sample is a good guess for the next one
+		E = mean2eccentric(M, ecc, i > 0 ? E : M);
+		ephemeris[i] = E;
 	}
-	return E;
 }
 
+double Orbit::EccentricAnomaly(double t) const noexcept {
+	const double M = mna + t;
+	// split M into full periods and remainder
+	const double periods = std::floor(M / (PI * 2.0));
+	const double m = M - periods * PI * 2.0;
+	if (ecc > max_ephemeris_ecc) {
+		// starting from M may diverge for very eccentric orbits, π doesn't
+		return mean2eccentric(m, ecc, PI) + periods * PI * 2.0;
+	}
+	if (ephemeris.empty()) {
+		return mean2eccentric(M, ecc);
+	}
+	const int samples = Resolution();
+	const double x = m / (PI * 2.0) * samples;
+	const int i = std::min(std::max(int(x), 0), samples - 1);
+	const double f = x - i;
+	// cubic hermite between neighbouring samples, dE/dM is 1/(1 - e cos E)
+	const double h = PI * 2.0 / samples;
+	const double E0 = ephemeris[i];
+	const double E1 = ephemeris[i + 1];
+	const double d0 = h / (1.0 - ecc * cos(E0));
+	const double d1 = h / (1.0 - ecc * cos(E1));
+	const double f2 = f * f;
+	const double f3 = f2 * f;
+	const double guess =
+		(2.0 * f3 - 3.0 * f2 + 1.0) * E0
+		+ (f3 - 2.0 * f2 + f) * d0
+		+ (-2.0 * f3 + 3.0 * f2) * E1
+		+ (f3 - f2) * d1;
+	return mean2eccentric(M, ecc, guess + periods * PI * 2.0);
 }
 
 glm::dmat4 Orbit::Matrix(double t) const noexcept {
-	double M = mna + t;
-	double E = mean2eccentric(M, ecc);
+	double E = EccentricAnomaly(t);
 
 	// coordinates in orbital plane, P=x, Q=-z
 	double P = sma * (cos(E) - ecc);
@@ -347,25 +470,58 @@ glm::dmat4 Orbit::Matrix(double t) const noexcept {
 }
 
 glm::dmat4 Orbit::InverseMatrix(double t) const noexcept {
-	double M = mna + t;
-	double E = mean2eccentric(M, ecc);
+	double E = EccentricAnomaly(t);
 	double P = sma * (cos(E) - ecc);
 	double Q = sma * sin(E) * sqrt(1 - (ecc * ecc));
 	return glm::translate(glm::dvec3(-P, 0.0, Q)) * glm::transpose(glm::yawPitchRoll(asc, inc, arg));
 }
 
+void Orbit::Matrices(double t, glm::dmat4 &matrix, glm::dmat4 &inverse) const noexcept {
+	double E = EccentricAnomaly(t);
+	double P = sma * (cos(E) - ecc);
+	double Q = sma * sin(E) * sqrt(1 - (ecc * ecc));
+	// rotation is orthonormal, so its inverse is the transpose
+	const glm::dmat4 rot(glm::yawPitchRoll(asc, inc, arg));
+	matrix = rot * glm::translate(glm::dvec3(P, 0.0, -Q));
+	inverse = glm::translate(glm::dvec3(-P, 0.0, Q)) * glm::transpose(rot);
+}
+
 
 Planet::Planet(int sidelength)
 : Body()
 , sidelength(sidelength)
 , tiles(TilesTotal())
-, vao() {
+, adjacency()
+, stock(TilesTotal(), 1.0f)
+, stock_time(TilesTotal(), 0.0)
+, resource_fields()
+, vao()
+, tile_texture()
+, dirty_tiles()
+, chunks()
+, chunk_roots{ 0 } {
 	Radius(double(sidelength) / 2.0);
+	BuildAdjacency();
 }
 
 Planet::~Planet() {
 }
 
+static_assert(sizeof(Tile) == sizeof(std::uint16_t), "tiles are read and written as raw data");
+
+bool Planet::ReadTiles(std::istream &in) {
+	const std::streamsize size = tiles.size() * sizeof(Tile);
+	in.read(reinterpret_cast<char *>(tiles.data()), size);
+	for (ResourceField &field : resource_fields) {
+		field.valid = false;
+	}
+	return in.gcount() == size;
+}
+
+void Planet::WriteTiles(std::ostream &out) const {
+	out.write(reinterpret_cast<const char *>(tiles.data()), tiles.size() * sizeof(Tile));
+}
+
 namespace {
 /// map p onto cube, s gives the surface, u and v the position in [-1,1]
 void cubemap(const glm::dvec3 &p, int &s, double &u, double &v) noexcept {
@@ -469,236 +625,550 @@ glm::dvec3 Planet::TileCenter(int srf, int x, int y, double e) const noexcept {
 	return glm::normalize(cubeunmap(srf, u, v)) * (Radius() + e);
 }
 
-void Planet::BuildVAO() {
-	vao.reset(new graphics::SimpleVAO<Attributes, unsigned int>);
-	vao->Bind();
-	vao->BindAttributes();
-	vao->EnableAttribute(0);
-	vao->EnableAttribute(1);
-	vao->EnableAttribute(2);
-	vao->EnableAttribute(3);
-	vao->EnableAttribute(4);
-	vao->EnableAttribute(5);
-	vao->AttributePointer<glm::vec3>(0, false, offsetof(Attributes, position));
-	vao->AttributePointer<glm::vec3>(1, false, offsetof(Attributes, normal));
-	vao->AttributePointer<glm::vec3>(2, false, offsetof(Attributes, tex_coord));
-	vao->AttributePointer<float>(3, false, offsetof(Attributes, shiny));
-	vao->AttributePointer<float>(4, false, offsetof(Attributes, glossy));
-	vao->AttributePointer<float>(5, false, offsetof(Attributes, metallic));
-	vao->ReserveAttributes(TilesTotal() * 4, GL_STATIC_DRAW);
-	{
-		auto attrib = vao->MapAttributes(GL_WRITE_ONLY);
-		float offset = Radius();
-
-		// srf  0  1  2  3  4  5
-		//  up +Z +X +Y -Z -X -Y
-
-		for (int index = 0, surface = 0; surface < 6; ++surface) {
-			for (int y = 0; y < sidelength; ++y) {
-				for (int x = 0; x < sidelength; ++x, ++index) {
-					glm::vec3 pos[4];
-					pos[0][(surface + 0) % 3] = float(x + 0) - offset;
-					pos[0][(surface + 1) % 3] = float(y + 0) - offset;
-					pos[0][(surface + 2) % 3] = offset;
-					pos[1][(surface + 0) % 3] = float(x + 0) - offset;
-					pos[1][(surface + 1) % 3] = float(y + 1) - offset;
-					pos[1][(surface + 2) % 3] = offset;
-					pos[2][(surface + 0) % 3] = float(x + 1) - offset;
-					pos[2][(surface + 1) % 3] = float(y + 0) - offset;
-					pos[2][(surface + 2) % 3] = offset;
-					pos[3][(surface + 0) % 3] = float(x + 1) - offset;
-					pos[3][(surface + 1) % 3] = float(y + 1) - offset;
-					pos[3][(surface + 2) % 3] = offset;
-
-					const TileType &t = TypeAt(surface, x, y);
-					float tex = t.texture;
-					const float tex_v_begin = surface < 3 ? 1.0f : 0.0f;
-					const float tex_v_end = surface < 3 ? 0.0f : 1.0f;
-
-					attrib[4 * index + 0].position = glm::normalize(pos[0]) * (surface < 3 ? offset : -offset);
-					attrib[4 * index + 0].normal = pos[0];
-					attrib[4 * index + 0].tex_coord[0] = 0.0f;
-					attrib[4 * index + 0].tex_coord[1] = tex_v_begin;
-					attrib[4 * index + 0].tex_coord[2] = tex;
-					attrib[4 * index + 0].shiny = t.shiny;
-					attrib[4 * index + 0].glossy = t.glossy;
-					attrib[4 * index + 0].metallic = t.metallic;
-
-					attrib[4 * index + 1].position = glm::normalize(pos[1]) * (surface < 3 ? offset : -offset);
-					attrib[4 * index + 1].normal = pos[1];
-					attrib[4 * index + 1].tex_coord[0] = 0.0f;
-					attrib[4 * index + 1].tex_coord[1] = tex_v_end;
-					attrib[4 * index + 1].tex_coord[2] = tex;
-					attrib[4 * index + 1].shiny = t.shiny;
-					attrib[4 * index + 1].glossy = t.glossy;
-					attrib[4 * index + 1].metallic = t.metallic;
-
-					attrib[4 * index + 2].position = glm::normalize(pos[2]) * (surface < 3 ? offset : -offset);
-					attrib[4 * index + 2].normal = pos[2];
-					attrib[4 * index + 2].tex_coord[0] = 1.0f;
-					attrib[4 * index + 2].tex_coord[1] = tex_v_begin;
-					attrib[4 * index + 2].tex_coord[2] = tex;
-					attrib[4 * index + 2].shiny = t.shiny;
-					attrib[4 * index + 2].glossy = t.glossy;
-					attrib[4 * index + 2].metallic = t.metallic;
-
-					attrib[4 * index + 3].position = glm::normalize(pos[3]) * (surface < 3 ? offset : -offset);
-					attrib[4 * index + 3].normal = pos[3];
-					attrib[4 * index + 3].tex_coord[0] = 1.0f;
-					attrib[4 * index + 3].tex_coord[1] = tex_v_end;
-					attrib[4 * index + 3].tex_coord[2] = tex;
-					attrib[4 * index + 3].shiny = t.shiny;
-					attrib[4 * index + 3].glossy = t.glossy;
-					attrib[4 * index + 3].metallic = t.metallic;
+int Planet::TileIndexAt(const glm::dvec3 &p) const noexcept {
+	int srf = 0;
+	double u = 0.0;
+	double v = 0.0;
+	cubemap(p, srf, u, v);
+	int x = glm::clamp(int(u * Radius() + Radius()), 0, sidelength - 1);
+	int y = glm::clamp(int(v * Radius() + Radius()), 0, sidelength - 1);
+	return IndexOf(srf, x, y);
+}
+
+const TileType &Planet::TypeAt(int index) const noexcept {
+	return GetSimulation().TileTypes()[TileAt(index).type];
+}
+
+glm::dvec3 Planet::TileCenter(int index, double e) const noexcept {
+	const int srf = index / TilesPerSurface();
+	const int y = (index % TilesPerSurface()) / sidelength;
+	const int x = index % sidelength;
+	return TileCenter(srf, x, y, e);
+}
+
+void Planet::BuildAdjacency() {
+	adjacency.resize(TilesTotal() * 4);
+	const glm::ivec2 dirs[4] = {
+		glm::ivec2(-1, 0),
+		glm::ivec2(1, 0),
+		glm::ivec2(0, -1),
+		glm::ivec2(0, 1),
+	};
+	for (int index = 0, srf = 0; srf < 6; ++srf) {
+		for (int y = 0; y < sidelength; ++y) {
+			for (int x = 0; x < sidelength; ++x, ++index) {
+				for (int d = 0; d < 4; ++d) {
+					const int nx = x + dirs[d].x;
+					const int ny = y + dirs[d].y;
+					if (nx >= 0 && nx < sidelength && ny >= 0 && ny < sidelength) {
+						adjacency[index * 4 + d] = IndexOf(srf, nx, ny);
+					} else {
+						// step over the edge and see where that lands on the cube
+						const double u = (double(nx) - Radius() + 0.5) / Radius();
+						const double v = (double(ny) - Radius() + 0.5) / Radius();
+						adjacency[index * 4 + d] = TileIndexAt(cubeunmap(srf, u, v));
+					}
 				}
 			}
 		}
 	}
-	vao->BindElements();
-	vao->ReserveElements(TilesTotal() * 6, GL_STATIC_DRAW);
-	{
-		auto element = vao->MapElements(GL_WRITE_ONLY);
-		int index = 0;
-		for (int surface = 0; surface < 3; ++surface) {
-			for (int y = 0; y < sidelength; ++y) {
-				for (int x = 0; x < sidelength; ++x, ++index) {
-					element[6 * index + 0] = 4 * index + 0;
-					element[6 * index + 1] = 4 * index + 2;
-					element[6 * index + 2] = 4 * index + 1;
-					element[6 * index + 3] = 4 * index + 1;
-					element[6 * index + 4] = 4 * index + 2;
-					element[6 * index + 5] = 4 * index + 3;
+}
+
+void Planet::SetTileType(int srf, int x, int y, int type) {
+	const int index = IndexOf(srf, x, y);
+	const TileType &old_type = TypeAt(index);
+	const TileType &new_type = GetSimulation().TileTypes()[type];
+	tiles[index].type = type;
+	// the old type's stock means nothing for the new one
+	stock[index] = 1.0f;
+	stock_time[index] = GetSimulation().Time();
+	if (tile_texture) {
+		dirty_tiles.push_back(index);
+	}
+	if (resource_fields.empty()) {
+		return;
+	}
+	for (const auto &yield : old_type.resources) {
+		if (new_type.FindResource(yield.resource) == new_type.resources.end()) {
+			// removing a source can increase distances anywhere, rebuild on demand
+			resource_fields[yield.resource].valid = false;
+		}
+	}
+	for (const auto &yield : new_type.resources) {
+		if (resource_fields[yield.resource].valid) {
+			RelaxResourceField(yield.resource, index);
+		}
+	}
+}
+
+TileVicinity::TileVicinity(const Planet &p, int center, int radius)
+: tiles(1, center)
+, ring_offset{ 0, 1 } {
+	for (int steps = 1; steps <= radius; ++steps) {
+		const int prev_begin = ring_offset[steps - 1];
+		const int prev_end = ring_offset[steps];
+		// neighbours of the previous ring can only be in it,
+		// the one before or the one being built
+		const int search_begin = ring_offset[std::max(steps - 2, 0)];
+		for (int i = prev_begin; i < prev_end; ++i) {
+			const int *neighbors = p.NeighborsOf(tiles[i]);
+			for (int n = 0; n < 4; ++n) {
+				if (std::find(tiles.begin() + search_begin, tiles.end(), neighbors[n]) == tiles.end()) {
+					tiles.push_back(neighbors[n]);
 				}
 			}
 		}
-		for (int surface = 3; surface < 6; ++surface) {
-			for (int y = 0; y < sidelength; ++y) {
-				for (int x = 0; x < sidelength; ++x, ++index) {
-					element[6 * index + 0] = 4 * index + 0;
-					element[6 * index + 1] = 4 * index + 1;
-					element[6 * index + 2] = 4 * index + 2;
-					element[6 * index + 3] = 4 * index + 2;
-					element[6 * index + 4] = 4 * index + 1;
-					element[6 * index + 5] = 4 * index + 3;
-				}
+		ring_offset.push_back(tiles.size());
+	}
+}
+
+double Planet::TileStock(int index) const noexcept {
+	const double regrown = (GetSimulation().Time() - stock_time[index]) * TypeAt(index).regrowth;
+	return std::min(1.0, stock[index] + regrown);
+}
+
+double Planet::DepleteTile(int index, double amount) noexcept {
+	const double capacity = TypeAt(index).capacity;
+	const double current = TileStock(index);
+	const double taken = std::min(amount, current * capacity);
+	stock[index] = current - taken / capacity;
+	stock_time[index] = GetSimulation().Time();
+	return taken;
+}
+
+int Planet::NearestResourceTile(int res, int tile) const {
+	UpdateResourceField(res);
+	return resource_fields[res].nearest[tile];
+}
+
+int Planet::ResourceDistance(int res, int tile) const {
+	UpdateResourceField(res);
+	return resource_fields[res].distance[tile];
+}
+
+void Planet::UpdateResourceField(int res) const {
+	if (resource_fields.empty()) {
+		resource_fields.resize(GetSimulation().Resources().Size());
+	}
+	ResourceField &field = resource_fields[res];
+	if (field.valid) {
+		return;
+	}
+	field.nearest.assign(TilesTotal(), -1);
+	field.distance.assign(TilesTotal(), -1);
+
+	// multi source BFS starting from all tiles that yield the resource
+	std::vector<int> queue;
+	queue.reserve(TilesTotal());
+	for (int index = 0; index < TilesTotal(); ++index) {
+		const TileType &type = TypeAt(index);
+		if (type.FindResource(res) != type.resources.end()) {
+			field.nearest[index] = index;
+			field.distance[index] = 0;
+			queue.push_back(index);
+		}
+	}
+	for (std::vector<int>::size_type head = 0; head < queue.size(); ++head) {
+		const int cur = queue[head];
+		const int *neighbors = NeighborsOf(cur);
+		for (int n = 0; n < 4; ++n) {
+			if (field.distance[neighbors[n]] < 0) {
+				field.nearest[neighbors[n]] = field.nearest[cur];
+				field.distance[neighbors[n]] = field.distance[cur] + 1;
+				queue.push_back(neighbors[n]);
+			}
+		}
+	}
+	field.valid = true;
+}
+
+void Planet::RelaxResourceField(int res, int tile) const {
+	ResourceField &field = resource_fields[res];
+	field.nearest[tile] = tile;
+	field.distance[tile] = 0;
+	// only visit tiles that actually got closer to a source
+	std::vector<int> queue(1, tile);
+	for (std::vector<int>::size_type head = 0; head < queue.size(); ++head) {
+		const int cur = queue[head];
+		const int *neighbors = NeighborsOf(cur);
+		for (int n = 0; n < 4; ++n) {
+			const int dist = field.distance[neighbors[n]];
+			if (dist < 0 || dist > field.distance[cur] + 1) {
+				field.nearest[neighbors[n]] = tile;
+				field.distance[neighbors[n]] = field.distance[cur] + 1;
+				queue.push_back(neighbors[n]);
 			}
 		}
 	}
-	vao->Unbind();
+}
+
+constexpr int Planet::chunk_size;
+constexpr float Planet::lod_threshold;
+constexpr int Planet::dirty_gap;
+
+namespace {
+/// position of the point at tile coordinates x,y on given surface
+/// projected onto a sphere with given radius, matching the vertices
+/// generated by the planet surface shader
+glm::vec3 surface_vertex(int surface, float x, float y, float radius) noexcept {
+	// srf  0  1  2  3  4  5
+	//  up +Z +X +Y -Z -X -Y
+	glm::vec3 pos;
+	pos[(surface + 0) % 3] = x - radius;
+	pos[(surface + 1) % 3] = y - radius;
+	pos[(surface + 2) % 3] = radius;
+	return glm::normalize(pos) * (surface < 3 ? radius : -radius);
+}
+}
+
+void Planet::BuildChunks() {
+	chunks.clear();
+	int top = 0;
+	while ((chunk_size << top) < sidelength) {
+		++top;
+	}
+	for (int surface = 0; surface < 6; ++surface) {
+		chunk_roots[surface] = BuildChunk(surface, 0, 0, top);
+	}
+}
+
+int Planet::BuildChunk(int surface, int x, int y, int level) {
+	const int index = chunks.size();
+	chunks.emplace_back();
+	{
+		Chunk &chunk = chunks.back();
+		chunk.surface = surface;
+		chunk.x = x;
+		chunk.y = y;
+		chunk.level = level;
+
+		const int step = 1 << level;
+		const int x_end = std::min(x + (chunk_size << level), sidelength);
+		const int y_end = std::min(y + (chunk_size << level), sidelength);
+		chunk.columns = (x_end - x + step - 1) / step;
+		chunk.count = chunk.columns * ((y_end - y + step - 1) / step) * 6;
+
+		const float r = Radius();
+		chunk.normal = glm::normalize(surface_vertex(surface, 0.5f * (x + x_end), 0.5f * (y + y_end), r));
+		// great circle edges keep the corners farthest from the center
+		const glm::vec3 corners[4] = {
+			surface_vertex(surface, x, y, r),
+			surface_vertex(surface, x_end, y, r),
+			surface_vertex(surface, x, y_end, r),
+			surface_vertex(surface, x_end, y_end, r),
+		};
+		float min_cos = 1.0f;
+		for (const glm::vec3 &corner : corners) {
+			min_cos = std::min(min_cos, glm::dot(chunk.normal, glm::normalize(corner)));
+		}
+		chunk.spread = std::acos(glm::clamp(min_cos, -1.0f, 1.0f));
+		chunk.center = chunk.normal * r;
+		chunk.radius = 2.0f * r * std::sin(0.5f * chunk.spread);
+	}
+
+	for (int child = 0; child < 4; ++child) {
+		chunks[index].children[child] = -1;
+	}
+	if (level > 0) {
+		const int half = chunk_size << (level - 1);
+		for (int child = 0; child < 4; ++child) {
+			const int cx = x + (child & 1) * half;
+			const int cy = y + (child >> 1) * half;
+			if (cx < sidelength && cy < sidelength) {
+				// no reference held across this, chunks may reallocate
+				const int c = BuildChunk(surface, cx, cy, level - 1);
+				chunks[index].children[child] = c;
+			}
+		}
+	}
+	return index;
+}
+
+void Planet::BuildVAO() {
+	BuildChunks();
+	vao.reset(new graphics::EmptyVAO);
+	tile_texture.reset(new graphics::BufferTexture);
+	tile_texture->Reserve(tiles.size() * sizeof(Tile), GL_R16UI, GL_DYNAMIC_DRAW);
+	tile_texture->Data(0, tiles.size() * sizeof(Tile), tiles.data());
+	dirty_tiles.clear();
+}
+
+void Planet::UploadTiles() {
+	if (dirty_tiles.empty()) return;
+
+	std::sort(dirty_tiles.begin(), dirty_tiles.end());
+	int begin = dirty_tiles.front();
+	int end = begin + 1;
+	for (int index : dirty_tiles) {
+		if (index > end + dirty_gap) {
+			tile_texture->Data(begin * sizeof(Tile), (end - begin) * sizeof(Tile), &tiles[begin]);
+			begin = index;
+		}
+		end = std::max(end, index + 1);
+	}
+	tile_texture->Data(begin * sizeof(Tile), (end - begin) * sizeof(Tile), &tiles[begin]);
+	dirty_tiles.clear();
 }
 
 void Planet::Draw(app::Assets &assets, graphics::Viewport &viewport) {
 	if (!vao) return;
 
+	graphics::PlanetSurface &shader = assets.shaders.planet_surface;
+	const glm::mat4 &mvp = shader.MVP();
+	const glm::mat4 &p = shader.P();
+
+	// frustum planes in model space, the projection has no far plane
+	glm::vec4 planes[5];
+	for (int i = 0; i < 5; ++i) {
+		const int row = i / 2;
+		const float sign = (i % 2) ? -1.0f : 1.0f;
+		for (int col = 0; col < 4; ++col) {
+			planes[i][col] = mvp[col][3] + sign * mvp[col][row];
+		}
+		planes[i] /= glm::length(glm::vec3(planes[i]));
+	}
+
+	const glm::vec3 cam(glm::inverse(shader.MV())[3]);
+	const float cam_dist = glm::length(cam);
+	const float radius = Radius();
+	// chunks further than this angle from the camera direction
+	// are behind the horizon
+	const float horizon = cam_dist > radius ? std::acos(radius / cam_dist) : PI;
+	const glm::vec3 cam_dir(cam_dist > 0.0f ? cam / cam_dist : glm::vec3(0.0f));
+	// pixels per unit of size at unit distance
+	const float pixel_scale = p[1][1] * 0.5f * viewport.Height();
+
+	UploadTiles();
+	shader.SetPlanet(radius, sidelength);
+	shader.SetTiles(*tile_texture);
 	vao->Bind();
-	vao->DrawTriangles(TilesTotal() * 6);
-}
-
-
-void GenerateEarthlike(const Set<TileType> &tiles, Planet &p) noexcept {
-	math::SimplexNoise elevation_gen(0);
-	math::SimplexNoise variation_gen(45623752346);
-
-	const int ice = tiles["ice"].id;
-	const int ocean = tiles["ocean"].id;
-	const int water = tiles["water"].id;
-	const int sand = tiles["sand"].id;
-	const int grass = tiles["grass"].id;
-	const int tundra = tiles["tundra"].id;
-	const int taiga = tiles["taiga"].id;
-	const int desert = tiles["desert"].id;
-	const int mntn = tiles["mountain"].id;
-	const int algae = tiles["algae"].id;
-	const int forest = tiles["forest"].id;
-	const int jungle = tiles["jungle"].id;
-	const int rock = tiles["rock"].id;
-	const int wheat = tiles["wheat"].id;
-
-	constexpr double ocean_thresh = -0.2;
-	constexpr double water_thresh = 0.0;
-	constexpr double beach_thresh = 0.05;
-	constexpr double highland_thresh = 0.4;
-	constexpr double mountain_thresh = 0.5;
+	std::vector<int> stack;
+	for (int surface = 5; surface >= 0; --surface) {
+		stack.push_back(chunk_roots[surface]);
+	}
+	while (!stack.empty()) {
+		const Chunk &chunk = chunks[stack.back()];
+		stack.pop_back();
 
-	const glm::dvec3 axis(0.0, 1.0, 0.0);
-	const double cap_thresh = std::abs(std::cos(p.AxialTilt().x));
-	const double equ_thresh = std::abs(std::sin(p.AxialTilt().x)) / 2.0;
-	const double fzone_start = equ_thresh - (equ_thresh - cap_thresh) / 3.0;
-	const double fzone_end = cap_thresh + (equ_thresh - cap_thresh) / 3.0;
+		const float angle = std::acos(glm::clamp(glm::dot(chunk.normal, cam_dir), -1.0f, 1.0f));
+		if (angle > horizon + chunk.spread) {
+			continue;
+		}
+		bool outside = false;
+		for (const glm::vec4 &plane : planes) {
+			if (glm::dot(glm::vec3(plane), chunk.center) + plane.w < -chunk.radius) {
+				outside = true;
+				break;
+			}
+		}
+		if (outside) {
+			continue;
+		}
 
-	for (int surface = 0; surface <= 5; ++surface) {
-		for (int y = 0; y < p.SideLength(); ++y) {
-			for (int x = 0; x < p.SideLength(); ++x) {
-				glm::dvec3 to_tile = p.TileCenter(surface, x, y);
-				double near_axis = std::abs(glm::dot(glm::normalize(to_tile), axis));
-				if (near_axis > cap_thresh) {
-					p.TileAt(surface, x, y).type = ice;
-					continue;
+		const float dist = std::max(glm::distance(cam, chunk.center) - chunk.radius, 1.0e-3f);
+		const float quad_size = float(1 << chunk.level) * pixel_scale / dist;
+		if (chunk.level > 0 && quad_size > lod_threshold) {
+			for (int child = 3; child >= 0; --child) {
+				if (chunk.children[child] >= 0) {
+					stack.push_back(chunk.children[child]);
 				}
-				float elevation = math::OctaveNoise(
-					elevation_gen,
-					glm::vec3(to_tile / p.Radius()),
-					3,   // octaves
-					0.5, // persistence
-					5 / p.Radius(), // frequency
-					2,   // amplitude
-					2    // growth
-				);
-				float variation = math::OctaveNoise(
-					variation_gen,
-					glm::vec3(to_tile / p.Radius()),
-					3,   // octaves
-					0.5, // persistence
-					16 / p.Radius(), // frequency
-					2,   // amplitude
-					2    // growth
-				);
-				if (elevation < ocean_thresh) {
-					p.TileAt(surface, x, y).type = ocean;
-				} else if (elevation < water_thresh) {
-					if (variation > 0.3) {
-						p.TileAt(surface, x, y).type = algae;
-					} else {
-						p.TileAt(surface, x, y).type = water;
-					}
-				} else if (elevation < beach_thresh) {
-					p.TileAt(surface, x, y).type = sand;
-				} else if (elevation < highland_thresh) {
-					if (near_axis < equ_thresh) {
-						if (variation > 0.6) {
-							p.TileAt(surface, x, y).type = grass;
-						} else if (variation > 0.2) {
-							p.TileAt(surface, x, y).type = sand;
-						} else {
-							p.TileAt(surface, x, y).type = desert;
-						}
-					} else if (near_axis < fzone_start) {
-						if (variation > 0.4) {
-							p.TileAt(surface, x, y).type = forest;
-						} else if (variation < -0.5) {
-							p.TileAt(surface, x, y).type = jungle;
-						} else if (variation > -0.02 && variation < 0.02) {
-							p.TileAt(surface, x, y).type = wheat;
-						} else {
-							p.TileAt(surface, x, y).type = grass;
-						}
-					} else if (near_axis < fzone_end) {
-						p.TileAt(surface, x, y).type = tundra;
-					} else {
-						p.TileAt(surface, x, y).type = taiga;
-					}
-				} else if (elevation < mountain_thresh) {
-					if (variation > 0.3) {
-						p.TileAt(surface, x, y).type = mntn;
-					} else {
-						p.TileAt(surface, x, y).type = rock;
-					}
+			}
+			continue;
+		}
+
+		shader.SetChunk(chunk.surface, chunk.x, chunk.y, 1 << chunk.level, chunk.columns);
+		vao->DrawTriangles(chunk.count);
+	}
+}
+
+namespace {
+
+/// tile IDs and climate thresholds for the earthlike generator,
+/// derived once per planet and shared by all row bands
+struct EarthlikeClimate {
+
+	int ice;
+	int ocean;
+	int water;
+	int sand;
+	int grass;
+	int tundra;
+	int taiga;
+	int desert;
+	int mntn;
+	int algae;
+	int forest;
+	int jungle;
+	int rock;
+	int wheat;
+
+	static constexpr double ocean_thresh = -0.2;
+	static constexpr double water_thresh = 0.0;
+	static constexpr double beach_thresh = 0.05;
+	static constexpr double highland_thresh = 0.4;
+	static constexpr double mountain_thresh = 0.5;
+
+	double cap_thresh;
+	double equ_thresh;
+	double fzone_start;
+	double fzone_end;
+
+	EarthlikeClimate(const Set<TileType> &tiles, const Planet &p)
+	: ice(tiles["ice"].id)
+	, ocean(tiles["ocean"].id)
+	, water(tiles["water"].id)
+	, sand(tiles["sand"].id)
+	, grass(tiles["grass"].id)
+	, tundra(tiles["tundra"].id)
+	, taiga(tiles["taiga"].id)
+	, desert(tiles["desert"].id)
+	, mntn(tiles["mountain"].id)
+	, algae(tiles["algae"].id)
+	, forest(tiles["forest"].id)
+	, jungle(tiles["jungle"].id)
+	, rock(tiles["rock"].id)
+	, wheat(tiles["wheat"].id)
+	, cap_thresh(std::abs(std::cos(p.AxialTilt().x)))
+	, equ_thresh(std::abs(std::sin(p.AxialTilt().x)) / 2.0)
+	, fzone_start(equ_thresh - (equ_thresh - cap_thresh) / 3.0)
+	, fzone_end(cap_thresh + (equ_thresh - cap_thresh) / 3.0) {
+	}
+
+	int Classify(double near_axis, float elevation, float variation) const noexcept {
+		if (near_axis > cap_thresh) {
+			return ice;
+		}
+		if (elevation < ocean_thresh) {
+			return ocean;
+		} else if (elevation < water_thresh) {
+			if (variation > 0.3) {
+				return algae;
+			} else {
+				return water;
+			}
+		} else if (elevation < beach_thresh) {
+			return sand;
+		} else if (elevation < highland_thresh) {
+			if (near_axis < equ_thresh) {
+				if (variation > 0.6) {
+					return grass;
+				} else if (variation > 0.2) {
+					return sand;
+				} else {
+					return desert;
+				}
+			} else if (near_axis < fzone_start) {
+				if (variation > 0.4) {
+					return forest;
+				} else if (variation < -0.5) {
+					return jungle;
+				} else if (variation > -0.02 && variation < 0.02) {
+					return wheat;
 				} else {
-					p.TileAt(surface, x, y).type = mntn;
+					return grass;
 				}
+			} else if (near_axis < fzone_end) {
+				return tundra;
+			} else {
+				return taiga;
 			}
+		} else if (elevation < mountain_thresh) {
+			if (variation > 0.3) {
+				return mntn;
+			} else {
+				return rock;
+			}
+		} else {
+			return mntn;
+		}
+	}
+
+};
+
+constexpr double EarthlikeClimate::ocean_thresh;
+constexpr double EarthlikeClimate::water_thresh;
+constexpr double EarthlikeClimate::beach_thresh;
+constexpr double EarthlikeClimate::highland_thresh;
+constexpr double EarthlikeClimate::mountain_thresh;
+
+/// rows of a surface handed to one job
+constexpr int earthlike_band = 8;
+
+/// fill rows [y_begin,y_end) of given surface
+/// touches nothing but those tiles, so bands may run concurrently
+void GenerateEarthlikeBand(
+	const EarthlikeClimate &climate,
+	const math::SimplexNoise &elevation_gen,
+	const math::SimplexNoise &variation_gen,
+	Planet &p,
+	int surface,
+	int y_begin,
+	int y_end
+) noexcept {
+	const glm::dvec3 axis(0.0, 1.0, 0.0);
+
+	// noise is evaluated for whole rows of tiles at once
+	const int side = p.SideLength();
+	std::vector<float> row_x(side);
+	std::vector<float> row_y(side);
+	std::vector<float> row_z(side);
+	std::vector<double> row_near_axis(side);
+	std::vector<float> row_elevation(side);
+	std::vector<float> row_variation(side);
+
+	for (int y = y_begin; y < y_end; ++y) {
+		for (int x = 0; x < side; ++x) {
+			glm::dvec3 to_tile = p.TileCenter(surface, x, y);
+			row_near_axis[x] = std::abs(glm::dot(glm::normalize(to_tile), axis));
+			glm::vec3 pos(to_tile / p.Radius());
+			row_x[x] = pos.x;
+			row_y[x] = pos.y;
+			row_z[x] = pos.z;
+		}
+		math::OctaveNoise<3, 2>( // octaves, growth
+			elevation_gen,
+			row_x.data(), row_y.data(), row_z.data(),
+			row_elevation.data(), side,
+			0.5, // persistence
+			5 / p.Radius(), // frequency
+			2    // amplitude
+		);
+		math::OctaveNoise<3, 2>( // octaves, growth
+			variation_gen,
+			row_x.data(), row_y.data(), row_z.data(),
+			row_variation.data(), side,
+			0.5, // persistence
+			16 / p.Radius(), // frequency
+			2    // amplitude
+		);
+		for (int x = 0; x < side; ++x) {
+			p.TileAt(surface, x, y).type = climate.Classify(row_near_axis[x], row_elevation[x], row_variation[x]);
 		}
 	}
+}
+
+}
+
+void GenerateEarthlike(const Set<TileType> &tiles, Planet &p) {
+	app::ThreadPool pool;
+	GenerateEarthlike(tiles, p, pool);
+}
+
+void GenerateEarthlike(const Set<TileType> &tiles, Planet &p, app::ThreadPool &pool) {
+	const math::SimplexNoise elevation_gen(0);
+	const math::SimplexNoise variation_gen(45623752346);
+	const EarthlikeClimate climate(tiles, p);
+
+	const int side = p.SideLength();
+	const int bands = (side + earthlike_band - 1) / earthlike_band;
+	pool.Run(6 * bands, [&](int job) {
+		const int surface = job / bands;
+		const int y_begin = (job % bands) * earthlike_band;
+		const int y_end = std::min(y_begin + earthlike_band, side);
+		GenerateEarthlikeBand(climate, elevation_gen, variation_gen, p, surface, y_begin, y_end);
+	});
+
+	// GL upload stays on the calling thread
 	p.BuildVAO();
 }
 
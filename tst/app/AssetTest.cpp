@@ -80,11 +80,11 @@ void AssetTest::testLoadUniverse() {
 
 	CPPUNIT_ASSERT_EQUAL_MESSAGE(
 		"wrong number of suns in default universe",
-		std::set<world::Sun *>::size_type(1), sim.Suns().size()
+		std::vector<world::Sun *>::size_type(1), sim.Suns().size()
 	);
 	CPPUNIT_ASSERT_EQUAL_MESSAGE(
 		"wrong number of planets in default universe",
-		std::set<world::Planet *>::size_type(3), sim.Planets().size()
+		std::vector<world::Planet *>::size_type(3), sim.Planets().size()
 	);
 	CPPUNIT_ASSERT_NO_THROW_MESSAGE(
 		"spawn planet does not exist",
@@ -39,7 +39,9 @@ void MasterTest::testOneSecond() {
 	blob->Name(assets.name.Sequential());
 	Spawn(*blob, sim.PlanetByName("Planet"));
 	// decrease chances of ur-blob dying without splitting
-	blob->GetProperties().Fertility() = 1.0;
+	creature::Genome::Properties<double> props(blob->GetProperties());
+	props.Fertility() = 1.0;
+	blob->SetProperties(props);
 	blob->BuildVAO();
 
 	app::MasterState state(assets, sim);
@@ -65,7 +67,9 @@ void MasterTest::testBasicInteraction() {
 	blob->Name(assets.name.Sequential());
 	Spawn(*blob, sim.PlanetByName("Planet"));
 	// decrease chances of ur-blob dying without splitting
-	blob->GetProperties().Fertility() = 1.0;
+	creature::Genome::Properties<double> props(blob->GetProperties());
+	props.Fertility() = 1.0;
+	blob->SetProperties(props);
 	blob->BuildVAO();
 
 	app::MasterState state(assets, sim);
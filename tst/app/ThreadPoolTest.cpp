@@ -0,0 +1,76 @@
+#include "ThreadPoolTest.hpp"
+
+#include "app/ThreadPool.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(blobs::app::test::ThreadPoolTest);
+
+
+namespace blobs {
+namespace app {
+namespace test {
+
+void ThreadPoolTest::setUp() {
+}
+
+void ThreadPoolTest::tearDown() {
+}
+
+
+void ThreadPoolTest::testRun() {
+	for (unsigned int workers : { 0u, 1u, 3u }) {
+		ThreadPool pool(workers);
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(
+			"wrong number of workers",
+			workers, pool.Workers()
+		);
+		// several runs to make sure the pool can be reused
+		for (int run = 0; run < 3; ++run) {
+			std::vector<int> calls(1000, 0);
+			pool.Run(calls.size(), [&](int i) { ++calls[i]; });
+			for (int i = 0; i < int(calls.size()); ++i) {
+				CPPUNIT_ASSERT_EQUAL_MESSAGE(
+					"every index must be called exactly once",
+					1, calls[i]
+				);
+			}
+		}
+	}
+}
+
+void ThreadPoolTest::testThrow() {
+	for (unsigned int workers : { 0u, 1u, 3u }) {
+		ThreadPool pool(workers);
+		std::atomic<int> calls(0);
+		CPPUNIT_ASSERT_THROW_MESSAGE(
+			"exception from a call not passed on to the caller",
+			pool.Run(1000, [&](int i) {
+				++calls;
+				if (i % 100 == 50) {
+					throw std::runtime_error("test");
+				}
+			}),
+			std::runtime_error
+		);
+		CPPUNIT_ASSERT_MESSAGE(
+			"remaining calls should be skipped after an exception",
+			calls < 1000
+		);
+		// the pool must be usable after a failed run
+		std::vector<int> seen(100, 0);
+		pool.Run(seen.size(), [&](int i) { ++seen[i]; });
+		for (int i = 0; i < int(seen.size()); ++i) {
+			CPPUNIT_ASSERT_EQUAL_MESSAGE(
+				"every index must be called exactly once after a failed run",
+				1, seen[i]
+			);
+		}
+	}
+}
+
+}
+}
+}
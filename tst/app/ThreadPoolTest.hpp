@@ -0,0 +1,34 @@
+#ifndef BLOBS_TEST_APP_THREADPOOLTEST_HPP_
+#define BLOBS_TEST_APP_THREADPOOLTEST_HPP_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+namespace blobs {
+namespace app {
+namespace test {
+
+class ThreadPoolTest
+: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE(ThreadPoolTest);
+
+CPPUNIT_TEST(testRun);
+CPPUNIT_TEST(testThrow);
+
+CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+	void tearDown();
+
+	void testRun();
+	void testThrow();
+
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,237 @@
+#include "CreatureTest.hpp"
+
+#include "app/Assets.hpp"
+#include "app/init.hpp"
+#include "creature/Creature.hpp"
+#include "creature/Goal.hpp"
+#include "creature/LocateResourceGoal.hpp"
+#include "creature/Situation.hpp"
+#include "world/Planet.hpp"
+#include "world/Simulation.hpp"
+#include "world/TileType.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(blobs::creature::test::CreatureTest, "headed");
+
+
+namespace blobs {
+namespace creature {
+namespace test {
+
+namespace {
+
+/// the per tick stats update lazy evaluation has to reproduce
+struct ReferenceStats {
+
+	Creature::Stats stats;
+	double time = 0.0;
+	double death = -1.0;
+
+	void Step(double dt) {
+		constexpr double dps[3] = { 1.0 / 4.0, 1.0 / 32.0, 1.0 / 128.0 };
+		for (auto &s : stats.stat) {
+			s.Add(s.gain * dt);
+		}
+		for (int i = 0; i < 3; ++i) {
+			if (stats.stat[i + 1].Full()) {
+				stats.Damage().Add(dps[i] * dt);
+			}
+		}
+		// resting
+		stats.Exhaustion().Add(stats.Exhaustion().gain * dt);
+		time += dt;
+		if (death < 0.0 && stats.Damage().Full()) {
+			death = time;
+		}
+	}
+
+	void AdvanceTo(double t) {
+		constexpr double max_step = 1.0e-3;
+		while (time < t && death < 0.0) {
+			Step(std::min(max_step, t - time));
+		}
+	}
+
+};
+
+void assert_stats(const std::string &msg, const ReferenceStats &expected, const Creature::Stats &actual) {
+	const char *names[] = { "damage", "breath", "thirst", "hunger", "exhaustion", "fatigue", "boredom" };
+	for (int i = 0; i < 7; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+			msg + ": " + names[i] + " differs from small steps",
+			expected.stats.stat[i].value, actual.stat[i].value, 1.0e-3);
+	}
+}
+
+}
+
+void CreatureTest::setUp() {
+}
+
+void CreatureTest::tearDown() {
+}
+
+
+void CreatureTest::testLineage() {
+	app::Init init(false, 1);
+	app::Assets assets;
+	world::Simulation sim(assets);
+
+	// four generations of splits below each of several roots
+	std::vector<std::uint64_t> lineages;
+	for (int root = 0; root < 8; ++root) {
+		lineages.push_back(sim.NextLineage());
+	}
+	for (std::size_t i = 0; i < lineages.size() && lineages.size() < 8 * 31; ++i) {
+		Creature c(sim, lineages[i]);
+		lineages.push_back(c.OffspringLineage(0));
+		lineages.push_back(c.OffspringLineage(1));
+	}
+
+	std::sort(lineages.begin(), lineages.end());
+	CPPUNIT_ASSERT_MESSAGE(
+		"two creatures share a lineage",
+		std::adjacent_find(lineages.begin(), lineages.end()) == lineages.end());
+}
+
+void CreatureTest::testSearchDepleted() {
+	app::Init init(false, 1);
+	app::Assets assets;
+	world::Simulation sim(assets);
+	assets.LoadUniverse("universe", sim);
+	world::Planet &planet = sim.PlanetByName("Planet");
+
+	// some tile type yielding a resource and one that doesn't
+	int food = -1;
+	int resource = -1;
+	int barren = -1;
+	for (int id = 0; id < int(sim.TileTypes().Size()) && food < 0; ++id) {
+		if (!sim.TileTypes()[id].resources.empty()) {
+			food = id;
+			resource = sim.TileTypes()[id].resources.front().resource;
+		}
+	}
+	for (int id = 0; id < int(sim.TileTypes().Size()) && barren < 0; ++id) {
+		const world::TileType &type = sim.TileTypes()[id];
+		if (type.FindResource(resource) == type.resources.end()) {
+			barren = id;
+		}
+	}
+	CPPUNIT_ASSERT_MESSAGE(
+		"need a tile type with and one without a resource",
+		food >= 0 && barren >= 0);
+
+	auto blob = new Creature(sim);
+	Spawn(*blob, planet);
+	// update perception
+	blob->TickMotion(0.0);
+
+	// spawn is in the middle of surface 0 facing +X, lay out
+	// barren land with a depleted patch right behind the creature
+	// and a stocked one two tiles ahead
+	const int mid = planet.SideLength() / 2;
+	for (int y = mid - 6; y <= mid + 6; ++y) {
+		for (int x = mid - 6; x <= mid + 6; ++x) {
+			planet.SetTileType(0, x, y, barren);
+		}
+	}
+	planet.SetTileType(0, mid - 1, mid, food);
+	planet.SetTileType(0, mid + 2, mid, food);
+	const int depleted = planet.TileIndexAt(planet.TileCenter(0, mid - 1, mid));
+	const int stocked = planet.TileIndexAt(planet.TileCenter(0, mid + 2, mid));
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"creature should be standing in the middle of surface 0",
+		planet.TileIndexAt(planet.TileCenter(0, mid, mid)), planet.TileIndexAt(blob->GetSituation().Position()));
+	planet.DepleteTile(depleted, 1.0e9);
+	CPPUNIT_ASSERT_MESSAGE(
+		"depleted tile should be empty",
+		planet.TileStock(depleted) < 0.01);
+	CPPUNIT_ASSERT_MESSAGE(
+		"creature should be able to see the stocked tile",
+		blob->PerceptionTest(planet.TileCenter(stocked)));
+
+	LocateResourceGoal goal(*blob);
+	goal.Accept(resource, 1.0);
+	goal.Action();
+	CPPUNIT_ASSERT_MESSAGE(
+		"stocked tile beyond a depleted one not found",
+		goal.Found());
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"creature headed for the wrong tile",
+		stocked, planet.TileIndexAt(goal.Target()));
+}
+
+void CreatureTest::testLazyStats() {
+	app::Init init(false, 1);
+	app::Assets assets;
+	world::Simulation sim(assets);
+	assets.LoadUniverse("universe", sim);
+
+	// not spawned, so it's never ticked and stays resting, its stats
+	// only get updated when they're looked at
+	auto blob = new Creature(sim);
+	Genome::Properties<double> props;
+	props.Lifetime() = 10000.0;
+	blob->SetProperties(props);
+
+	// thirst fills up at 60s, hunger at 200s, and breath at 250s,
+	// the healing cancels the thirst damage and keeps damage at zero
+	// until then, exhaustion recovers twice as fast while resting,
+	// and the final blow comes at about 251.4s
+	ReferenceStats ref;
+	ref.time = sim.Time();
+	ref.stats.Exhaustion().value = 0.9;
+	ref.stats.Damage().gain = -0.03;
+	ref.stats.Breath().gain = 1.0 / 250.0;
+	ref.stats.Thirst().gain = 1.0 / 60.0;
+	ref.stats.Hunger().gain = 1.0 / 200.0;
+	ref.stats.Exhaustion().gain = -1.0 / 400.0;
+	ref.stats.Fatigue().gain = 1.0 / 1000.0;
+	blob->AddStat(Creature::Stats::EXHAUSTION, 0.9);
+	for (int i = 0; i < 7; ++i) {
+		blob->StatGain(i, ref.stats.stat[i].gain);
+	}
+	const double birth = sim.Time();
+
+	// big leaps, some crossing several thresholds at once
+	for (double t : { 30.0, 100.0, 220.0, 250.5 }) {
+		sim.Tick(birth + t - sim.Time());
+		blob->CheckStats();
+		ref.AdvanceTo(sim.Time());
+		assert_stats("after " + std::to_string(int(t)) + "s", ref, blob->GetStats());
+		CPPUNIT_ASSERT_MESSAGE(
+			"creature died early",
+			!blob->Dead());
+	}
+	CPPUNIT_ASSERT_MESSAGE(
+		"thirst, hunger, and breath should be full by now",
+		blob->GetStats().Thirst().Full() && blob->GetStats().Hunger().Full() && blob->GetStats().Breath().Full());
+	CPPUNIT_ASSERT_MESSAGE(
+		"exhaustion should have recovered fully",
+		blob->GetStats().Exhaustion().Empty());
+
+	// from here on check every tick like the creature's body would
+	const double tick = 1.0 / 60.0;
+	while (!blob->Dead() && sim.Time() - birth < 260.0) {
+		sim.Tick(tick);
+		blob->CheckStats();
+	}
+	ref.AdvanceTo(birth + 260.0);
+	CPPUNIT_ASSERT_MESSAGE(
+		"creature should be dead by now",
+		blob->Dead());
+	CPPUNIT_ASSERT_MESSAGE(
+		"reference should be dead by now",
+		ref.death > 0.0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+		"creature died at the wrong time",
+		ref.death - birth, blob->Age(), tick + 1.0e-3);
+}
+
+}
+}
+}
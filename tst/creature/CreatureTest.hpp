@@ -0,0 +1,36 @@
+#ifndef BLOBS_TEST_CREATURE_CREATURETEST_HPP_
+#define BLOBS_TEST_CREATURE_CREATURETEST_HPP_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+namespace blobs {
+namespace creature {
+namespace test {
+
+class CreatureTest
+: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE(CreatureTest);
+
+CPPUNIT_TEST(testLineage);
+CPPUNIT_TEST(testSearchDepleted);
+CPPUNIT_TEST(testLazyStats);
+
+CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+	void tearDown();
+
+	void testLineage();
+	void testSearchDepleted();
+	void testLazyStats();
+
+};
+
+}
+}
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include "math/GaloisLFSR.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <sstream>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(blobs::math::test::GaloisLFSRTest);
@@ -49,6 +50,75 @@ void GaloisLFSRTest::testFromContainer() {
 	}
 }
 
+void GaloisLFSRTest::testWordStep() {
+	// drawing whole words must match drawing single bits
+	GaloisLFSR bitwise(0x6283B64CEFE57925);
+	GaloisLFSR wordwise(0x6283B64CEFE57925);
+	for (int i = 0; i < 64; ++i) {
+		for (int j = 0; j < 8; ++j) {
+			bitwise();
+		}
+		uint8_t expected8;
+		bitwise(expected8);
+		for (int j = 0; j < 8; ++j) {
+			wordwise();
+		}
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(
+			"8 bit value differs from one drawn bit by bit",
+			expected8, wordwise.Next<uint8_t>()
+		);
+		for (int j = 0; j < 64; ++j) {
+			bitwise();
+		}
+		uint64_t expected64;
+		bitwise(expected64);
+		for (int j = 0; j < 64; ++j) {
+			wordwise();
+		}
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(
+			"64 bit value differs from one drawn bit by bit",
+			expected64, wordwise.Next<uint64_t>()
+		);
+	}
+}
+
+void GaloisLFSRTest::testJump() {
+	GaloisLFSR stepped(7);
+	GaloisLFSR jumped(7);
+	for (uint64_t n : { 0, 1, 5, 31, 32, 33, 64, 100, 1000 }) {
+		for (uint64_t i = 0; i < n; ++i) {
+			stepped();
+		}
+		jumped.Jump(n);
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(
+			"jump ahead differs from stepping",
+			stepped.Next<uint64_t>(), jumped.Next<uint64_t>()
+		);
+	}
+}
+
+void GaloisLFSRTest::testSplit() {
+	GaloisLFSR random(8);
+	GaloisLFSR same(random.Split(0));
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"stream 0 differs from original",
+		random.Next<uint64_t>(), same.Next<uint64_t>()
+	);
+
+	GaloisLFSR first(random.Split(1));
+	GaloisLFSR second(random.Split(2));
+	GaloisLFSR jumped(random);
+	jumped.Jump(uint64_t(2) << 40);
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"stream 2 does not start 2^41 bits in",
+		jumped.Next<uint64_t>(), second.Next<uint64_t>()
+	);
+	CPPUNIT_ASSERT_MESSAGE(
+		"streams 1 and 2 are the same",
+		first.Next<uint64_t>() != second.Next<uint64_t>()
+	);
+}
+
 void GaloisLFSRTest::AssertBetween(
 	string message,
 	float minimum,
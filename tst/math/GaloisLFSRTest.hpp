@@ -18,6 +18,9 @@ CPPUNIT_TEST_SUITE(GaloisLFSRTest);
 
 CPPUNIT_TEST(testFloatNorm);
 CPPUNIT_TEST(testFromContainer);
+CPPUNIT_TEST(testWordStep);
+CPPUNIT_TEST(testJump);
+CPPUNIT_TEST(testSplit);
 
 CPPUNIT_TEST_SUITE_END();
 
@@ -27,6 +30,9 @@ public:
 
 	void testFloatNorm();
 	void testFromContainer();
+	void testWordStep();
+	void testJump();
+	void testSplit();
 
 	/// check if value is in range [minimum,maximum]
 	static void AssertBetween(
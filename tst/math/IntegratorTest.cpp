@@ -0,0 +1,81 @@
+#include "IntegratorTest.hpp"
+
+#include "math/const.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(blobs::math::test::IntegratorTest);
+
+
+namespace blobs {
+namespace math {
+namespace test {
+
+void IntegratorTest::setUp() {
+}
+
+void IntegratorTest::tearDown() {
+}
+
+
+void IntegratorTest::testEuler() {
+	// symplectic, so error must not grow
+	double drift = EnergyDrift(EULER);
+	CPPUNIT_ASSERT_MESSAGE(
+		"semi-implicit euler drifts too much",
+		drift < 0.02);
+}
+
+void IntegratorTest::testVerlet() {
+	double drift = EnergyDrift(VERLET);
+	CPPUNIT_ASSERT_MESSAGE(
+		"verlet drifts too much",
+		drift < 0.0005);
+	CPPUNIT_ASSERT_MESSAGE(
+		"verlet not better than euler",
+		drift < EnergyDrift(EULER));
+}
+
+void IntegratorTest::testRK4() {
+	double drift = EnergyDrift(RK4);
+	CPPUNIT_ASSERT_MESSAGE(
+		"RK4 drifts too much",
+		drift < 0.00001);
+	CPPUNIT_ASSERT_MESSAGE(
+		"RK4 not better than verlet",
+		drift < EnergyDrift(VERLET));
+}
+
+namespace {
+
+struct Derivative {
+	double vel;
+	double acc;
+	Derivative(double vel = 0.0, double acc = 0.0)
+	: vel(vel), acc(acc) { }
+};
+
+}
+
+double IntegratorTest::EnergyDrift(Integrator method) {
+	constexpr double dt = 0.05;
+	const int steps = int(100.0 * 2.0 * PI / dt);
+	double pos = 1.0;
+	double vel = 0.0;
+	double drift = 0.0;
+	for (int i = 0; i < steps; ++i) {
+		Derivative f(Integrate<Derivative>(method, [&](const Derivative &ds, double t) {
+			// spring with unit mass and stiffness
+			return Derivative(vel + ds.acc * t, -(pos + ds.vel * t));
+		}, dt));
+		pos += f.vel * dt;
+		vel += f.acc * dt;
+		drift = std::max(drift, std::abs(0.5 * (pos * pos + vel * vel) - 0.5));
+	}
+	return drift;
+}
+
+}
+}
+}
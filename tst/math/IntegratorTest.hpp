@@ -0,0 +1,42 @@
+#ifndef BLOBS_TEST_MATH_INTEGRATORTEST_HPP
+#define BLOBS_TEST_MATH_INTEGRATORTEST_HPP
+
+#include "math/Integrator.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+namespace blobs {
+namespace math {
+namespace test {
+
+class IntegratorTest
+: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE(IntegratorTest);
+
+CPPUNIT_TEST(testEuler);
+CPPUNIT_TEST(testVerlet);
+CPPUNIT_TEST(testRK4);
+
+CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+	void tearDown();
+
+	void testEuler();
+	void testVerlet();
+	void testRK4();
+
+	/// run a harmonic oscillator for 100 periods and return
+	/// the largest deviation from its initial energy
+	static double EnergyDrift(Integrator);
+
+};
+
+}
+}
+}
+
+#endif
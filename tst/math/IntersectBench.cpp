@@ -0,0 +1,102 @@
+#include "IntersectBench.hpp"
+
+#include "math/const.hpp"
+#include "math/GaloisLFSR.hpp"
+#include "math/geometry.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <glm/gtx/transform.hpp>
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(blobs::math::test::IntersectBench, "bench");
+
+
+namespace blobs {
+namespace math {
+namespace test {
+
+void IntersectBench::setUp() {
+}
+
+void IntersectBench::tearDown() {
+}
+
+
+namespace {
+
+glm::dmat4 random_transform(GaloisLFSR &random) {
+	// about half of the pairs end up intersecting
+	return glm::translate(glm::dvec3(random.SNorm(), random.SNorm(), random.SNorm()) * 2.5)
+		* glm::rotate(random.UNorm() * PI * 2.0, glm::normalize(glm::dvec3(random.SNorm(), random.SNorm(), random.SNorm()) + glm::dvec3(0.0, 0.0, 0.001)));
+}
+
+}
+
+void IntersectBench::benchBoxBox() {
+	constexpr int num_boxes = 1024;
+	constexpr int rounds = 200;
+	constexpr int pairs = num_boxes * OBBPacket::SIZE * rounds;
+
+	GaloisLFSR random(0x2C6E12D4A9F5B387);
+	AABB box{ { -0.5, -0.5, -0.5 }, { 0.5, 0.5, 0.5 } };
+	std::vector<glm::dmat4> a(num_boxes);
+	std::vector<glm::dmat4> b(num_boxes * OBBPacket::SIZE);
+	std::vector<OBBPacket> packets(num_boxes);
+	for (int i = 0; i < num_boxes; ++i) {
+		a[i] = random_transform(random);
+		for (int j = 0; j < OBBPacket::SIZE; ++j) {
+			b[i * OBBPacket::SIZE + j] = random_transform(random);
+			packets[i].Add(box, b[i * OBBPacket::SIZE + j]);
+		}
+	}
+
+	int scalar_hits = 0;
+	const auto scalar_start = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		for (int i = 0; i < num_boxes; ++i) {
+			for (int j = 0; j < OBBPacket::SIZE; ++j) {
+				glm::dvec3 normal;
+				double depth;
+				if (Intersect(box, a[i], box, b[i * OBBPacket::SIZE + j], normal, depth)) {
+					++scalar_hits;
+				}
+			}
+		}
+	}
+	const std::chrono::duration<double, std::nano> scalar_time(std::chrono::steady_clock::now() - scalar_start);
+
+	int packet_hits = 0;
+	const auto packet_start = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		for (int i = 0; i < num_boxes; ++i) {
+			glm::vec3 normal[OBBPacket::SIZE];
+			float depth[OBBPacket::SIZE];
+			const int mask = Intersect(box, a[i], packets[i], normal, depth);
+			for (int j = 0; j < OBBPacket::SIZE; ++j) {
+				if (mask & (1 << j)) {
+					++packet_hits;
+				}
+			}
+		}
+	}
+	const std::chrono::duration<double, std::nano> packet_time(std::chrono::steady_clock::now() - packet_start);
+
+	std::cout << std::endl
+		<< "box/box scalar: " << (scalar_time.count() / pairs) << "ns per pair" << std::endl
+		<< "box/box packet: " << (packet_time.count() / pairs) << "ns per pair" << std::endl;
+
+	// the packet's tolerance may let the odd grazing pair through
+	CPPUNIT_ASSERT_MESSAGE(
+		"packet reports fewer hits than scalar",
+		packet_hits >= scalar_hits
+	);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+		"packet and scalar hit counts differ",
+		double(scalar_hits), double(packet_hits), pairs * 0.001
+	);
+}
+
+}
+}
+}
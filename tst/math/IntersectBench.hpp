@@ -0,0 +1,32 @@
+#ifndef BLOBS_TEST_MATH_INTERSECTBENCH_HPP_
+#define BLOBS_TEST_MATH_INTERSECTBENCH_HPP_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+namespace blobs {
+namespace math {
+namespace test {
+
+class IntersectBench
+: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE(IntersectBench);
+
+CPPUNIT_TEST(benchBoxBox);
+
+CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+	void tearDown();
+
+	void benchBoxBox();
+
+};
+
+}
+}
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include "../assert.hpp"
 
 #include "math/const.hpp"
+#include "math/GaloisLFSR.hpp"
 #include "math/geometry.hpp"
 
 #include <limits>
@@ -223,6 +224,161 @@ void IntersectTest::testBoxBoxIntersection() {
 	);
 }
 
+void IntersectTest::testBoxBoxAxisHint() {
+	const double delta = std::numeric_limits<double>::epsilon();
+	double depth = 0;
+	glm::dvec3 normal(0);
+	glm::dvec3 axis(0);
+
+	AABB box{ { -1, -1, -1 }, { 1, 1, 1 } }; // 2x2x2 cube centered around origin
+	glm::dmat4 Ma(glm::rotate(PI * 0.25, glm::dvec3(0, 0, 1))); // rotated 45° around Z
+	glm::dmat4 Mb(glm::translate(glm::dvec3(3, 0, 0))); // 3 to the right
+
+	CPPUNIT_ASSERT_MESSAGE(
+		"OBBs intersect (one rotated by 45°, no hint)",
+		!Intersect(box, Ma, box, Mb, normal, depth, axis)
+	);
+	CPPUNIT_ASSERT_MESSAGE(
+		"no separating axis reported",
+		!allzero(axis)
+	);
+	CPPUNIT_ASSERT_MESSAGE(
+		"OBBs intersect (one rotated by 45°, with hint)",
+		!Intersect(box, Ma, box, Mb, normal, depth, axis)
+	);
+
+	// move closer, hint no longer separates
+	Mb = glm::translate(glm::dvec3(2.4, 0, 0)); // 2.4 to the right
+	CPPUNIT_ASSERT_MESSAGE(
+		"OBBs don't intersect (one rotated by 45°, stale hint)",
+		Intersect(box, Ma, box, Mb, normal, depth, axis)
+	);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+		"bad penetration depth (stale hint)",
+		0.014213562373095, depth, delta
+	);
+	AssertEqual(
+		"bad intersection normal (stale hint)",
+		glm::dvec3(1, 0, 0), glm::abs(normal)
+	);
+	AssertEqual(
+		"hint not set to normal after intersection",
+		normal, axis
+	);
+}
+
+void IntersectTest::testBoxBoxPacket() {
+	const float delta = 1.0e-5f;
+
+	AABB box{ { -1, -1, -1 }, { 1, 1, 1 } }; // 2x2x2 cube centered around origin
+	glm::dmat4 Ma(glm::rotate(PI * 0.25, glm::dvec3(0, 0, 1))); // rotated 45° around Z
+	glm::dmat4 Mb[4] = {
+		glm::dmat4(1.0), // same center
+		glm::translate(glm::dvec3(2.4, 0, 0)), // 2.4 to the right
+		glm::translate(glm::dvec3(3, 0, 0)), // 3 to the right
+		glm::translate(glm::dvec3(0, 5, 0)), // 5 up
+	};
+
+	OBBPacket packet;
+	for (int i = 0; i < 4; ++i) {
+		CPPUNIT_ASSERT_MESSAGE(
+			"failed to add box to packet",
+			packet.Add(box, Mb[i])
+		);
+	}
+	CPPUNIT_ASSERT_MESSAGE(
+		"added box to full packet",
+		!packet.Add(box, Mb[0])
+	);
+
+	glm::vec3 normal[OBBPacket::SIZE];
+	float depth[OBBPacket::SIZE];
+	int mask = Intersect(box, Ma, packet, normal, depth);
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"bad intersection mask",
+		0x3, mask
+	);
+
+	// compare to scalar version
+	for (int i = 0; i < 4; ++i) {
+		glm::dvec3 s_normal(0);
+		double s_depth = 0;
+		bool s_hit = Intersect(box, Ma, box, Mb[i], s_normal, s_depth);
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(
+			"packet and scalar results differ",
+			s_hit, bool(mask & (1 << i))
+		);
+		if (!s_hit) continue;
+		CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+			"packet and scalar penetration depths differ",
+			s_depth, depth[i], delta
+		);
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+		"bad penetration depth (2.4 to the right)",
+		0.014213562373095, depth[1], delta
+	);
+	AssertEqual(
+		"bad intersection normal (2.4 to the right)",
+		glm::vec3(1, 0, 0), glm::abs(normal[1]), delta
+	);
+
+	// unused lanes never report a hit
+	packet.count = 1;
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"bad intersection mask (one lane)",
+		0x1, Intersect(box, Ma, packet)
+	);
+}
+
+void IntersectTest::testBoxBoxPacketConservative() {
+	AABB box{ { -1, -1, -1 }, { 1, 1, 1 } }; // 2x2x2 cube centered around origin
+
+	// far away from the origin and barely touching, at these coordinates
+	// float rounding alone would open a gap of about 5e-4 between them
+	const glm::dvec3 far(8190.5005, 0, 0);
+	glm::dmat4 Ma(glm::translate(far));
+	glm::dmat4 Mb(glm::translate(far + glm::dvec3(2.0 - 1.0e-6, 0, 0)));
+	glm::dvec3 s_normal(0);
+	double s_depth = 0;
+	CPPUNIT_ASSERT_MESSAGE(
+		"grazing boxes don't intersect in double precision",
+		Intersect(box, Ma, box, Mb, s_normal, s_depth)
+	);
+	OBBPacket packet;
+	packet.origin = far;
+	packet.Add(box, Mb);
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"packet misses grazing boxes far from the origin",
+		0x1, Intersect(box, Ma, packet)
+	);
+
+	// the packet may report extra hits, but never miss one
+	GaloisLFSR random(0x5EED5EED5EED5EED);
+	for (int i = 0; i < 1000; ++i) {
+		const glm::dvec3 a_pos(far + glm::dvec3(random.SNorm(), random.SNorm(), random.SNorm()));
+		Ma = glm::translate(a_pos)
+			* glm::rotate(random.UNorm() * PI * 2.0, glm::normalize(glm::dvec3(random.SNorm(), random.SNorm(), random.SNorm()) + glm::dvec3(0, 0, 0.001)));
+		packet.count = 0;
+		packet.origin = a_pos;
+		glm::dmat4 Mbs[OBBPacket::SIZE];
+		for (int j = 0; j < OBBPacket::SIZE; ++j) {
+			Mbs[j] = glm::translate(a_pos + glm::dvec3(random.SNorm(), random.SNorm(), random.SNorm()) * 3.0)
+				* glm::rotate(random.UNorm() * PI * 2.0, glm::normalize(glm::dvec3(random.SNorm(), random.SNorm(), random.SNorm()) + glm::dvec3(0, 0, 0.001)));
+			packet.Add(box, Mbs[j]);
+		}
+		const int mask = Intersect(box, Ma, packet);
+		for (int j = 0; j < OBBPacket::SIZE; ++j) {
+			if (Intersect(box, Ma, box, Mbs[j], s_normal, s_depth)) {
+				CPPUNIT_ASSERT_MESSAGE(
+					"packet rejected a pair the scalar test accepts",
+					mask & (1 << j)
+				);
+			}
+		}
+	}
+}
+
 void IntersectTest::testRaySphereIntersection() {
 	const double epsilon = std::numeric_limits<double>::epsilon();
 	Ray ray{ { 0.0, 0.0, 0.0 }, { 1.0, 0.0, 0.0 } }; // at origin, pointing right
@@ -15,6 +15,9 @@ CPPUNIT_TEST_SUITE(IntersectTest);
 
 CPPUNIT_TEST(testRayBoxIntersection);
 CPPUNIT_TEST(testBoxBoxIntersection);
+CPPUNIT_TEST(testBoxBoxAxisHint);
+CPPUNIT_TEST(testBoxBoxPacket);
+CPPUNIT_TEST(testBoxBoxPacketConservative);
 CPPUNIT_TEST(testRaySphereIntersection);
 
 CPPUNIT_TEST_SUITE_END();
@@ -25,6 +28,9 @@ public:
 
 	void testRayBoxIntersection();
 	void testBoxBoxIntersection();
+	void testBoxBoxAxisHint();
+	void testBoxBoxPacket();
+	void testBoxBoxPacketConservative();
 	void testRaySphereIntersection();
 
 };
@@ -1,12 +1,14 @@
 #include "StabilityTest.hpp"
 
 #include "math/GaloisLFSR.hpp"
+#include "math/OctaveNoise.hpp"
 #include "math/SimplexNoise.hpp"
 #include "math/WorleyNoise.hpp"
 
 #include <cstdint>
 #include <string>
 #include <sstream>
+#include <vector>
 #include <glm/gtx/io.hpp>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(blobs::math::test::StabilityTest);
@@ -253,6 +255,66 @@ void StabilityTest::testSimplex() {
 	Assert(noise, glm::vec3(-1.0f, -1.0f, -1.0f),  0.0f);
 }
 
+void StabilityTest::testSimplexBatch() {
+	SimplexNoise noise(0);
+	GaloisLFSR random(1);
+
+	// odd count so the tail gets tested as well
+	constexpr int count = 1023;
+	vector<float> x(count), y(count), z(count), out(count);
+	for (int i = 0; i < 27; ++i) {
+		// lattice points around the origin
+		x[i] = float(i % 3 - 1);
+		y[i] = float((i / 3) % 3 - 1);
+		z[i] = float(i / 9 - 1);
+	}
+	for (int i = 27; i < count; ++i) {
+		x[i] = random.SNorm() * 100.0;
+		y[i] = random.SNorm() * 100.0;
+		z[i] = random.SNorm() * 100.0;
+	}
+
+	noise(x.data(), y.data(), z.data(), out.data(), count);
+	for (int i = 0; i < count; ++i) {
+		const glm::vec3 position(x[i], y[i], z[i]);
+		stringstream msg;
+		msg << "batched simplex noise differs from single at " << position;
+		CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+			msg.str(),
+			noise(position), out[i], numeric_limits<float>::epsilon()
+		);
+	}
+}
+
+void StabilityTest::testOctaveBatch() {
+	SimplexNoise noise(0);
+	GaloisLFSR random(3);
+
+	// more than one block
+	constexpr int count = 200;
+	vector<float> x(count), y(count), z(count), out(count);
+	for (int i = 0; i < count; ++i) {
+		x[i] = random.SNorm();
+		y[i] = random.SNorm();
+		z[i] = random.SNorm();
+	}
+
+	OctaveNoise<3, 2>(noise, x.data(), y.data(), z.data(), out.data(), count, 0.5f, 0.25f, 2.0f);
+	for (int i = 0; i < count; ++i) {
+		const glm::vec3 position(x[i], y[i], z[i]);
+		stringstream msg;
+		msg << "batched octave noise differs from single at " << position;
+		CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+			msg.str(),
+			OctaveNoise(noise, position, 3, 0.5f, 0.25f, 2.0f, 2.0f), out[i], numeric_limits<float>::epsilon()
+		);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+			msg.str(),
+			(OctaveNoise<3, 2>(noise, position, 0.5f, 0.25f, 2.0f)), out[i], numeric_limits<float>::epsilon()
+		);
+	}
+}
+
 void StabilityTest::testWorley() {
 	WorleyNoise noise(0);
 
@@ -274,6 +336,38 @@ void StabilityTest::testWorley() {
 	Assert(noise, glm::vec3(-1.0f, -1.0f, -1.0f), -0.575981974601746f);
 }
 
+void StabilityTest::testWorleyBatch() {
+	WorleyNoise noise(0);
+	GaloisLFSR random(2);
+
+	constexpr int count = 1000;
+	vector<float> x(count), y(count), z(count), f1(count), f2(count);
+	for (int i = 0; i < count; ++i) {
+		x[i] = random.SNorm() * 10.0;
+		y[i] = random.SNorm() * 10.0;
+		z[i] = random.SNorm() * 10.0;
+	}
+
+	noise(x.data(), y.data(), z.data(), f1.data(), f2.data(), count);
+	for (int i = 0; i < count; ++i) {
+		const glm::vec3 position(x[i], y[i], z[i]);
+		stringstream msg;
+		msg << "batched worley noise differs from single at " << position;
+		CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+			msg.str(),
+			noise(position), 2.0f * f1[i] - 1.0f, numeric_limits<float>::epsilon()
+		);
+		CPPUNIT_ASSERT_MESSAGE(
+			"second closest point closer than closest",
+			f1[i] <= f2[i]
+		);
+		CPPUNIT_ASSERT_MESSAGE(
+			"second closest point farther than cap",
+			f2[i] <= 1.0f
+		);
+	}
+}
+
 void StabilityTest::Assert(
 	const SimplexNoise &noise,
 	const glm::vec3 &position,
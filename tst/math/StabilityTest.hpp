@@ -22,7 +22,10 @@ CPPUNIT_TEST_SUITE(StabilityTest);
 
 CPPUNIT_TEST(testRNG);
 CPPUNIT_TEST(testSimplex);
+CPPUNIT_TEST(testSimplexBatch);
+CPPUNIT_TEST(testOctaveBatch);
 CPPUNIT_TEST(testWorley);
+CPPUNIT_TEST(testWorleyBatch);
 
 CPPUNIT_TEST_SUITE_END();
 
@@ -32,7 +35,10 @@ public:
 
 	void testRNG();
 	void testSimplex();
+	void testSimplexBatch();
+	void testOctaveBatch();
 	void testWorley();
+	void testWorleyBatch();
 
 	static void Assert(
 		const SimplexNoise &noise,
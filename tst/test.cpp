@@ -8,11 +8,20 @@ using CppUnit::TextUi::TestRunner;
 
 int main(int argc, char **argv) {
 	bool headless = false;
+	bool bench = false;
 	if (argc > 1 && std::strcmp(argv[1], "--headless") == 0) {
 		headless = true;
 	}
+	if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+		bench = true;
+	}
 
 	TestRunner runner;
+	if (bench) {
+		TestFactoryRegistry &registry = TestFactoryRegistry::getRegistry("bench");
+		runner.addTest(registry.makeTest());
+		return runner.run() ? 0 : 1;
+	}
 	{
 		TestFactoryRegistry &registry = TestFactoryRegistry::getRegistry();
 		runner.addTest(registry.makeTest());
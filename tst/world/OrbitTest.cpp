@@ -5,6 +5,8 @@
 #include "math/const.hpp"
 #include "world/Orbit.hpp"
 
+#include <cmath>
+
 CPPUNIT_TEST_SUITE_REGISTRATION(blobs::world::test::OrbitTest);
 
 using blobs::test::AssertEqual;
@@ -783,6 +785,59 @@ void OrbitTest::testInverseMnAn() {
 		epsilon
 	);
 }
+
+void OrbitTest::testEphemeris() {
+	constexpr double epsilon = 1.0e-12;
+
+	Orbit exact;
+	exact.Resolution(0);
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"wrong resolution after disabling ephemeris",
+		0, exact.Resolution()
+	);
+
+	Orbit orbit;
+	orbit.Resolution(64);
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"wrong ephemeris resolution",
+		64, orbit.Resolution()
+	);
+
+	for (double e : { 0.0, 0.1, 0.5, 0.75 }) {
+		orbit.Eccentricity(e);
+		exact.Eccentricity(e);
+		// cover a few periods in both directions at odd intervals
+		for (double t = -PI * 6.0; t < PI * 6.0; t += 0.0123) {
+			const double E = orbit.EccentricAnomaly(t);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+				"eccentric anomaly does not satisfy Kepler's equation",
+				t, E - e * std::sin(E), epsilon
+			);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+				"eccentric anomaly differs from exact solution",
+				exact.EccentricAnomaly(t), E, epsilon
+			);
+		}
+	}
+}
+
+void OrbitTest::testEphemerisHighEcc() {
+	constexpr double epsilon = 1.0e-12;
+
+	Orbit orbit;
+	orbit.Resolution(16);
+	for (double e : { 0.9, 0.99 }) {
+		orbit.Eccentricity(e);
+		for (double t = 0.0; t < PI * 2.0; t += 0.0123) {
+			const double E = orbit.EccentricAnomaly(t);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+				"eccentric anomaly does not satisfy Kepler's equation",
+				t, E - e * std::sin(E), epsilon
+			);
+		}
+	}
+}
+
 }
 }
 }
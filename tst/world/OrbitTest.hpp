@@ -29,6 +29,9 @@ CPPUNIT_TEST(testInverseLngAsc);
 CPPUNIT_TEST(testInverseArgPe);
 CPPUNIT_TEST(testInverseMnAn);
 
+CPPUNIT_TEST(testEphemeris);
+CPPUNIT_TEST(testEphemerisHighEcc);
+
 CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -51,6 +54,9 @@ public:
 	void testInverseArgPe();
 	void testInverseMnAn();
 
+	void testEphemeris();
+	void testEphemerisHighEcc();
+
 };
 
 }
@@ -3,8 +3,11 @@
 #include "../assert.hpp"
 
 #include "world/Planet.hpp"
+#include "world/TileVicinity.hpp"
 
+#include <algorithm>
 #include <limits>
+#include <sstream>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(blobs::world::test::PlanetTest);
 
@@ -33,6 +36,118 @@ void PlanetTest::testPositionConversion() {
 		2.5, p.Radius(), std::numeric_limits<double>::epsilon());
 }
 
+void PlanetTest::testAdjacency() {
+	Planet p(5);
+
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"wrong tile count of planet",
+		150, p.TileCount());
+	for (int tile = 0; tile < p.TileCount(); ++tile) {
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(
+			"tile center does not map back to tile",
+			tile, p.TileIndexAt(p.TileCenter(tile)));
+		const int *neighbors = p.NeighborsOf(tile);
+		for (int n = 0; n < 4; ++n) {
+			CPPUNIT_ASSERT_MESSAGE(
+				"tile is its own neighbor",
+				neighbors[n] != tile);
+			const int *back = p.NeighborsOf(neighbors[n]);
+			CPPUNIT_ASSERT_MESSAGE(
+				"adjacency is not symmetric",
+				back[0] == tile || back[1] == tile || back[2] == tile || back[3] == tile);
+		}
+	}
+}
+
+void PlanetTest::testTileData() {
+	Planet a(5);
+	for (int srf = 0; srf < 6; ++srf) {
+		for (int y = 0; y < a.SideLength(); ++y) {
+			for (int x = 0; x < a.SideLength(); ++x) {
+				a.TileAt(srf, x, y).type = srf * 25 + y * 5 + x;
+			}
+		}
+	}
+	std::stringstream data;
+	a.WriteTiles(data);
+
+	Planet b(5);
+	CPPUNIT_ASSERT_MESSAGE(
+		"failed to read tile data",
+		b.ReadTiles(data));
+	for (int tile = 0; tile < b.TileCount(); ++tile) {
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(
+			"tile type differs after reading back",
+			a.TileAt(tile).type, b.TileAt(tile).type);
+	}
+
+	Planet c(6);
+	data.clear();
+	data.seekg(0);
+	CPPUNIT_ASSERT_MESSAGE(
+		"reading too little tile data should fail",
+		!c.ReadTiles(data));
+}
+
+void PlanetTest::testVicinity() {
+	Planet p(5);
+
+	// a surface's middle tile has a diamond of 1 + 4 + 8 tiles within two steps
+	const TileVicinity middle(p, 12, 2);
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"wrong radius of vicinity",
+		2, middle.Radius());
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"wrong center of vicinity",
+		12, middle.Center());
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"wrong number of tiles in vicinity",
+		13, middle.Tiles().size());
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"wrong number of tiles in ring 0",
+		1, middle.Ring(0).size());
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"wrong number of tiles in ring 1",
+		4, middle.Ring(1).size());
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(
+		"wrong number of tiles in ring 2",
+		8, middle.Ring(2).size());
+
+	for (int tile = 0; tile < p.TileCount(); ++tile) {
+		const TileVicinity vicinity(p, tile, 3);
+		std::vector<int> seen(vicinity.begin(), vicinity.end());
+		std::sort(seen.begin(), seen.end());
+		CPPUNIT_ASSERT_MESSAGE(
+			"tile appears more than once in vicinity",
+			std::adjacent_find(seen.begin(), seen.end()) == seen.end());
+
+		const int *neighbors = p.NeighborsOf(tile);
+		const TileVicinity::Range ring = vicinity.Ring(1);
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(
+			"first ring should be the adjacent tiles",
+			4, ring.size());
+		for (int n = 0; n < 4; ++n) {
+			CPPUNIT_ASSERT_MESSAGE(
+				"adjacent tile missing from first ring",
+				std::find(ring.begin(), ring.end(), neighbors[n]) != ring.end());
+		}
+
+		for (int steps = 1; steps <= 3; ++steps) {
+			const TileVicinity::Range inner = vicinity.Ring(steps - 1);
+			for (int t : vicinity.Ring(steps)) {
+				const int *adjacent = p.NeighborsOf(t);
+				bool linked = false;
+				for (int n = 0; n < 4; ++n) {
+					linked = linked || std::find(inner.begin(), inner.end(), adjacent[n]) != inner.end();
+				}
+				CPPUNIT_ASSERT_MESSAGE(
+					"ring tile not adjacent to previous ring",
+					linked);
+			}
+		}
+	}
+}
+
 }
 }
 }
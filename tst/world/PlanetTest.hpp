@@ -14,6 +14,9 @@ class PlanetTest
 CPPUNIT_TEST_SUITE(PlanetTest);
 
 CPPUNIT_TEST(testPositionConversion);
+CPPUNIT_TEST(testAdjacency);
+CPPUNIT_TEST(testTileData);
+CPPUNIT_TEST(testVicinity);
 
 CPPUNIT_TEST_SUITE_END();
 
@@ -22,6 +25,9 @@ public:
 	void tearDown();
 
 	void testPositionConversion();
+	void testAdjacency();
+	void testTileData();
+	void testVicinity();
 
 };
 
@@ -0,0 +1,274 @@
+#include "SimulationTest.hpp"
+
+#include "app/Assets.hpp"
+#include "app/ThreadPool.hpp"
+#include "app/init.hpp"
+#include "creature/Creature.hpp"
+#include "creature/Situation.hpp"
+#include "world/Planet.hpp"
+#include "world/Resource.hpp"
+#include "world/Simulation.hpp"
+#include "world/TileType.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(blobs::world::test::SimulationTest, "headed");
+
+
+namespace blobs {
+namespace world {
+namespace test {
+
+namespace {
+
+/// steps from given tile to every other one
+std::vector<int> bfs(const Planet &planet, int from) {
+	std::vector<int> steps(planet.TileCount(), -1);
+	std::vector<int> queue(1, from);
+	steps[from] = 0;
+	for (std::size_t head = 0; head < queue.size(); ++head) {
+		const int *neighbors = planet.NeighborsOf(queue[head]);
+		for (int n = 0; n < 4; ++n) {
+			if (steps[neighbors[n]] < 0) {
+				steps[neighbors[n]] = steps[queue[head]] + 1;
+				queue.push_back(neighbors[n]);
+			}
+		}
+	}
+	return steps;
+}
+
+/// compare planet's resource field against one BFS per source tile
+void assert_field(const std::string &msg, const Planet &planet, int resource, const std::vector<int> &sources) {
+	std::vector<std::vector<int>> steps;
+	for (int source : sources) {
+		steps.push_back(bfs(planet, source));
+	}
+	for (int tile = 0; tile < planet.TileCount(); ++tile) {
+		int expected = -1;
+		for (const auto &s : steps) {
+			if (expected < 0 || s[tile] < expected) {
+				expected = s[tile];
+			}
+		}
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(
+			msg + ": wrong distance for tile " + std::to_string(tile),
+			expected, planet.ResourceDistance(resource, tile));
+		const int nearest = planet.NearestResourceTile(resource, tile);
+		if (sources.empty()) {
+			CPPUNIT_ASSERT_EQUAL_MESSAGE(
+				msg + ": nearest tile without any source",
+				-1, nearest);
+			continue;
+		}
+		auto source = std::find(sources.begin(), sources.end(), nearest);
+		CPPUNIT_ASSERT_MESSAGE(
+			msg + ": nearest of tile " + std::to_string(tile) + " is not a source",
+			source != sources.end());
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(
+			msg + ": nearest of tile " + std::to_string(tile) + " is not at that distance",
+			expected, steps[source - sources.begin()][tile]);
+	}
+}
+
+}
+
+void SimulationTest::setUp() {
+}
+
+void SimulationTest::tearDown() {
+}
+
+
+void SimulationTest::testTickPairing() {
+	app::Init init(false, 1);
+	app::Assets assets;
+
+	Simulation sim(assets);
+	assets.LoadUniverse("universe", sim);
+	Planet &planet = sim.PlanetByName("Planet");
+	CPPUNIT_ASSERT_MESSAGE(
+		"planet too small to leave the 48 unit band",
+		planet.Radius() > 24.0);
+
+	auto blob = new creature::Creature(sim);
+	Spawn(*blob, planet);
+	const glm::dvec3 start(blob->GetSituation().Position());
+	sim.SetFocus(planet, start, nullptr);
+
+	// walk along a great circle so the distance to the focus crosses
+	// the 16 and 48 unit bands while the creature is moving
+	bool crossed_near = false;
+	bool crossed_far = false;
+	for (int i = 0; i < 1200; ++i) {
+		creature::Situation::State state(blob->GetSituation().GetState());
+		const glm::dvec3 normal(planet.NormalAt(state.pos));
+		state.vel = glm::normalize(glm::cross(glm::dvec3(0.0, 1.0, 0.0), normal)) * 20.0;
+		blob->GetSituation().SetState(state);
+
+		sim.Tick(1.0 / 60.0);
+
+		const double dist = glm::length(blob->GetSituation().Position() - start);
+		crossed_near = crossed_near || dist > 16.0;
+		crossed_far = crossed_far || dist > 48.0;
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(
+			"motion and life ticks of creature got out of step",
+			blob->LastTick(), blob->LastLifeTick());
+	}
+	CPPUNIT_ASSERT_MESSAGE(
+		"creature never left the near band",
+		crossed_near);
+	CPPUNIT_ASSERT_MESSAGE(
+		"creature never left the middle band",
+		crossed_far);
+}
+
+void SimulationTest::testTileStock() {
+	app::Init init(false, 1);
+	app::Assets assets;
+
+	Simulation sim(assets);
+	assets.LoadUniverse("universe", sim);
+	Planet &planet = sim.PlanetByName("Planet");
+
+	const int tile = planet.TileIndexAt(planet.TileCenter(0, 0, 0));
+	const TileType &type = planet.TypeAt(tile);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+		"fresh tile should be fully stocked",
+		1.0, planet.TileStock(tile), std::numeric_limits<float>::epsilon());
+
+	const double taken = planet.DepleteTile(tile, type.capacity * 0.25);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+		"wrong amount taken from tile",
+		type.capacity * 0.25, taken, type.capacity * 1.0e-6);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+		"wrong stock after depletion",
+		0.75, planet.TileStock(tile), 1.0e-6);
+
+	const double rest = planet.DepleteTile(tile, type.capacity * 10.0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+		"depletion should stop at what's left",
+		type.capacity * 0.75, rest, type.capacity * 1.0e-6);
+
+	planet.SetTileType(0, 0, 0, type.id);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+		"changing tile type should restock the tile",
+		1.0, planet.TileStock(tile), std::numeric_limits<float>::epsilon());
+}
+
+
+void SimulationTest::testParallelGenerate() {
+	app::Init init(false, 1);
+	app::Assets assets;
+
+	Simulation sim(assets);
+	assets.LoadUniverse("universe", sim);
+	Planet &planet = sim.PlanetByName("Planet");
+
+	app::ThreadPool serial(0);
+	GenerateEarthlike(sim.TileTypes(), planet, serial);
+	std::vector<int> expected(planet.TileCount());
+	for (int i = 0; i < planet.TileCount(); ++i) {
+		expected[i] = planet.TileAt(i).type;
+	}
+
+	for (unsigned int workers : { 1u, 3u, 7u }) {
+		// wipe so tiles left untouched would show
+		for (int srf = 0; srf < 6; ++srf) {
+			for (int y = 0; y < planet.SideLength(); ++y) {
+				for (int x = 0; x < planet.SideLength(); ++x) {
+					planet.TileAt(srf, x, y).type = std::numeric_limits<std::uint16_t>::max();
+				}
+			}
+		}
+		app::ThreadPool pool(workers);
+		GenerateEarthlike(sim.TileTypes(), planet, pool);
+		for (int i = 0; i < planet.TileCount(); ++i) {
+			CPPUNIT_ASSERT_EQUAL_MESSAGE(
+				"parallel generation differs from serial output at tile " + std::to_string(i)
+					+ " with " + std::to_string(workers) + " workers",
+				expected[i], int(planet.TileAt(i).type));
+		}
+	}
+}
+
+void SimulationTest::testResourceField() {
+	app::Init init(false, 1);
+	app::Assets assets;
+
+	Simulation sim(assets);
+	assets.LoadUniverse("universe", sim);
+	Planet &planet = sim.PlanetByName("Planet");
+
+	// a tile type yielding some resource and one that doesn't
+	int food = -1;
+	int resource = -1;
+	int barren = -1;
+	for (int id = 0; id < int(sim.TileTypes().Size()) && food < 0; ++id) {
+		if (!sim.TileTypes()[id].resources.empty()) {
+			food = id;
+			resource = sim.TileTypes()[id].resources.front().resource;
+		}
+	}
+	for (int id = 0; id < int(sim.TileTypes().Size()) && barren < 0; ++id) {
+		const TileType &type = sim.TileTypes()[id];
+		if (type.FindResource(resource) == type.resources.end()) {
+			barren = id;
+		}
+	}
+	CPPUNIT_ASSERT_MESSAGE(
+		"need a tile type with and one without a resource",
+		food >= 0 && barren >= 0);
+
+	const int side = planet.SideLength();
+	for (int srf = 0; srf < 6; ++srf) {
+		for (int y = 0; y < side; ++y) {
+			for (int x = 0; x < side; ++x) {
+				planet.SetTileType(srf, x, y, barren);
+			}
+		}
+	}
+	std::vector<int> sources;
+	assert_field("barren planet", planet, resource, sources);
+
+	// corners, edges, and the middle of surfaces, so distances cross faces
+	const int spots[][3] = {
+		{ 0, 0, 0 },
+		{ 2, side - 1, side / 2 },
+		{ 4, side / 2, side / 2 },
+		{ 5, side - 1, 0 },
+		{ 3, 1, side - 2 },
+	};
+	for (const auto &spot : spots) {
+		// field is valid at this point, so it's relaxed in place
+		planet.SetTileType(spot[0], spot[1], spot[2], food);
+		sources.push_back(planet.TileIndexAt(planet.TileCenter(spot[0], spot[1], spot[2])));
+		assert_field("after adding source " + std::to_string(sources.size()), planet, resource, sources);
+	}
+
+	// removing sources invalidates the field
+	planet.SetTileType(spots[2][0], spots[2][1], spots[2][2], barren);
+	sources.erase(sources.begin() + 2);
+	assert_field("after removing a source", planet, resource, sources);
+
+	planet.SetTileType(spots[0][0], spots[0][1], spots[0][2], barren);
+	sources.erase(sources.begin());
+	// move a source over by one tile
+	planet.SetTileType(spots[0][0], spots[0][1] + 1, spots[0][2], food);
+	sources.push_back(planet.TileIndexAt(planet.TileCenter(spots[0][0], spots[0][1] + 1, spots[0][2])));
+	assert_field("after moving a source", planet, resource, sources);
+
+	for (const auto &spot : spots) {
+		planet.SetTileType(spot[0], spot[1], spot[2], barren);
+	}
+	planet.SetTileType(spots[0][0], spots[0][1] + 1, spots[0][2], barren);
+	sources.clear();
+	assert_field("after removing all sources", planet, resource, sources);
+}
+}
+}
+}
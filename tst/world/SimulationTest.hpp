@@ -0,0 +1,38 @@
+#ifndef BLOBS_TEST_WORLD_SIMULATIONTEST_HPP_
+#define BLOBS_TEST_WORLD_SIMULATIONTEST_HPP_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+namespace blobs {
+namespace world {
+namespace test {
+
+class SimulationTest
+: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE(SimulationTest);
+
+CPPUNIT_TEST(testTickPairing);
+CPPUNIT_TEST(testTileStock);
+CPPUNIT_TEST(testParallelGenerate);
+CPPUNIT_TEST(testResourceField);
+
+CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+	void tearDown();
+
+	void testTickPairing();
+	void testTileStock();
+	void testParallelGenerate();
+	void testResourceField();
+
+};
+
+}
+}
+}
+
+#endif